@@ -1,841 +1,230 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "pio_matrix.pio.h"
+#include "framebuffer.h"
+#include "animacoes.h"
+#include "uso.h"
+#include "teclado.h"
+#include "ocioso.h"
+#include "suave.h"
+#include "telemetria.h"
+#include "latencia.h"
+#include "fluxo.h"
+#include "gravador.h"
+#if FLUXO
+#include "pico/stdio_usb.h"
+#include "hardware/sync.h"
+#endif
 
 // Definições
-#define NUM_PIXELS 25
-#define OUT_PIN 7
-#define LINHA_QNTD 4
-#define COLUNA_QNTD 4
-#define FPS 10 // Frames por segundo (100 ms por frame)
+#define LEITURA_MS 5 // Intervalo entre leituras dos eventos do teclado
+#define RELATORIO_USO_MS 5000 // Intervalo entre relatórios de ocupação dos núcleos
+#define OCIOSO_APOS_MS 1000 // Tempo sem teclas, com a saída parada, antes de entrar no modo ocioso
 
-typedef struct {
-    double frame[NUM_PIXELS];
-    double color[3];
-    uint32_t ms_time;
-} scene;
+// Máquina de estados do pio_matrix, usada pelo núcleo 1
+static PIO pio_saida;
+static uint sm_saida;
 
-// Mapas de GPIOs para teclado
-const uint gpioCol[COLUNA_QNTD] = {4, 3, 2, 1};
-const uint gpioLinha[LINHA_QNTD] = {10, 9, 8, 5};
+// Núcleo 1 sem animação e com o último frame já travado nos LEDs
+static volatile bool saida_parada = true;
 
-// Mapeamento das teclas do teclado
-const char teclado[LINHA_QNTD][COLUNA_QNTD] = {
-    {'1', '2', '3', 'A'},
-    {'4', '5', '6', 'B'},
-    {'7', '8', '9', 'C'},
-    {'*', '0', '#', 'D'}};
+// Fila de comandos do núcleo 1 (o núcleo 0 só lê os contadores)
+static comandos_t fila;
 
-// Funções auxiliares
-uint32_t rgb_color(double r, double g, double b) {
-    unsigned char R = r * 255;
-    unsigned char G = g * 255;
-    unsigned char B = b * 255;
-    return (G << 24) | (R << 16) | (B << 8);
-}
+// Núcleo 1: renderização e saída. Recebe comandos pela FIFO entre núcleos e
+// roda a animação atual nos seus prazos, sem depender da varredura do teclado.
+void nucleo1_main() {
+    // O DMA é configurado aqui para que sua IRQ seja atendida neste núcleo
+    framebuffer_init(pio_saida, sm_saida);
+    comandos_init(&fila);
 
-// Inicialização do GPIO
-void init_gpio() {
-    for (int i = 0; i < LINHA_QNTD; i++) {
-        gpio_init(gpioLinha[i]);
-        gpio_set_dir(gpioLinha[i], GPIO_OUT);
-        gpio_put(gpioLinha[i], 1);
-    }
-    for (int i = 0; i < COLUNA_QNTD; i++) {
-        gpio_init(gpioCol[i]);
-        gpio_set_dir(gpioCol[i], GPIO_IN);
-        gpio_pull_up(gpioCol[i]);
-    }
-}
+    animacao_t animacao;
+    animacao_parar(&animacao);
 
-// Escaneia o teclado
-char escanear_teclado() {
-    for (int row = 0; row < LINHA_QNTD; row++) {
-        gpio_put(gpioLinha[row], 0);
-        for (int col = 0; col < COLUNA_QNTD; col++) {
-            if (!gpio_get(gpioCol[col])) {
-                gpio_put(gpioLinha[row], 1);
-                return teclado[row][col];
-            }
+    while (true) {
+        uso_ocupado();
+        // Cada comando chega em duas palavras: o passo e o instante da tecla
+        // (32 bits baixos). Os que chegam juntos se combinam na fila.
+        while (multicore_fifo_rvalid()) {
+            saida_parada = false;
+            latencia_comando();
+            comando_evento_t evento;
+            evento.comando = (animacao_passo_t)multicore_fifo_pop_blocking();
+            hal_tempo_t agora = hal_agora();
+            evento.instante = agora - (uint32_t)((uint32_t)agora - multicore_fifo_pop_blocking());
+            evento.tipo = comando_tipo(evento.comando);
+            comandos_por(&fila, &evento);
         }
-        gpio_put(gpioLinha[row], 1);
-    }
-    return 0; // Nenhuma tecla pressionada
-}
-
-
-// Função alterar a cor do vermelho para o verde
-uint32_t cor_transicao(int frame, int max_frames) {
-    // Valor do vermelho começa em 1 (máximo) e vai diminuindo
-    double r = 1.0 - (double)frame / max_frames; 
-    // Valor do verde começa em 0 e vai aumentando
-    double g = (double)frame / max_frames; 
-    // Azul permanece em 0
-    double b = 0.0; 
-
-    // Retorna a cor com a interpolação de vermelho para verde
-    return rgb_color(r, g, b);
-}
-
-// Função de animação com transição de vermelho para verde
-void animacao_1(PIO pio, uint sm) {
-    double frames[5][25] = {
-        {1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-    };
-
-    int max_frames = 5; // Número de frames na animação
-
-    for (int frame = 0; frame < max_frames; frame++) {
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            // Se o valor for 1 (LED aceso), atribuímos a cor com transição
-            if (frames[frame][i] == 1) {
-                uint32_t color = cor_transicao(frame, max_frames);  // Cor com transição
-                pio_sm_put_blocking(pio, sm, color); // Mostra o LED com a cor
-            } else {
-                // Se for 0 (LED apagado), atribuímos a cor preta
-                uint32_t color = rgb_color(0, 0, 0); // Cor preta (apagado)
-                pio_sm_put_blocking(pio, sm, color); // Desliga o LED
+        // Cada comando substitui a animação anterior; os que ainda têm outros
+        // atrás (modos, ou o de tela seguido deles) rodam o primeiro passo já
+        comando_evento_t evento;
+        while (comandos_tirar(&fila, &evento, hal_agora())) {
+            gravador_tecla(tecla_do_comando(evento.comando));
+            animacao_iniciar(&animacao, evento.comando, hal_agora());
+            if (comandos_vazia(&fila)) {
+                break;
             }
+            animacao_executar(&animacao, hal_agora());
         }
-        sleep_ms(1000 / FPS);  // Delay entre os frames para controlar a animação
-    }
-}
-
-// Animação de um "X" acendendo em uma matriz de LEDs 5x5
-void animacao_2(PIO pio, uint sm) {
-    // Frames do "X" acendendo
-    double x_pattern[5][25] = {
-        {1, 0, 0, 0, 1,  // Primeiro frame
-        0, 1, 0, 1, 0,
-        0, 0, 1, 0, 0,
-        0, 1, 0, 1, 0,
-        1, 0, 0, 0, 1},
-
-        {0, 0, 0, 0, 0,  // Segundo frame
-        0, 1, 0, 1, 0,
-        0, 0, 1, 0, 0,
-        0, 1, 0, 1, 0,
-        0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Terceiro frame
-        0, 0, 0, 0, 0,
-        0, 1, 1, 1, 0,
-        0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Quarto frame
-        0, 0, 0, 0, 0,
-        0, 1, 1, 1, 0,
-        0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Quinto frame
-        0, 0, 0, 0, 0,
-        0, 1, 0, 1, 0,
-        0, 0, 1, 0, 0,
-        0, 0, 0, 0, 0}
-    };
-
-    int max_frames = 5; // Número de frames na animação
-
-    for (int frame = 0; frame < max_frames; frame++) {
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            // Se o valor for 1 (LED aceso), atribuímos a cor com transição
-            if (x_pattern[frame][i] == 1) {
-                uint32_t color = cor_transicao(frame, max_frames); // Cor com transição
-                pio_sm_put_blocking(pio, sm, color); // Mostra o LED com a cor
-            } else {
-                // Se for 0 (LED apagado), atribuímos a cor preta
-                uint32_t color = rgb_color(0, 0, 0); // Cor preta (apagado)
-                pio_sm_put_blocking(pio, sm, color); // Desliga o LED
-            }
-        }
-        sleep_ms(1000 / FPS); // Delay entre os frames para controlar a animação
-    }
-}
-
-
-// Função para desligar todos os LEDs
-void desligar_leds(PIO pio, uint sm) {
-    // Todos os LEDs desligados (cor preta)
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t color = rgb_color(0, 0, 0); // Cor preta (apagado)
-        pio_sm_put_blocking(pio, sm, color); // Envia a cor preta para todos os LEDs
-    }
-}
-
-void animacao_0(PIO pio, uint sm){
-    int max_frames = 7;
-
-    scene animation [] = {
-        {
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0,
-                0, 1, 0, 1, 0
-            },
-            {0,0,0.5},
-            500
-        },{
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                0, 0, 0, 0, 0,
-                0, 1, 0, 1, 0
-            },
-            {0,0,0.5},
-            500
-        },{
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                0, 0, 0, 0, 0,
-                0, 0, 0, 1, 0
-            },
-            {0,0,0.5},
-            200
-        },{
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                0, 0, 0, 0, 0,
-                0, 1, 0, 1, 0
-            },
-            {0,0,0.5},
-            500
-        },{
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0
-            },
-            {0,0,0.5},
-            200
-        },{
-            {
-                0, 0, 0, 0, 0,
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                0, 0, 0, 0, 0,
-                0, 1, 0, 1, 0
-            },
-            {0,0,0.5},
-            200
-        },{
-            {
-                0, 1, 1, 1, 0,
-                1, 0, 0, 0, 1,
-                1, 1, 1, 1, 1,
-                0, 0, 0, 0, 0,
-                0, 1, 0, 1, 0
-            },
-            {0,0,0.5},
-            1000
-        }
-    };
-
-    for (int frame = 0; frame < max_frames; frame++) {
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            if (animation[frame].frame[i]) {
-                uint32_t color = rgb_color(animation[frame].color[0], animation[frame].color[1], animation[frame].color[2]);
-                pio_sm_put_blocking(pio, sm, color);
-            } else {
-                uint32_t color = rgb_color(0, 0, 0);
-                pio_sm_put_blocking(pio, sm, color);
-            }
+        hal_tempo_t prazo = animacao_executar(&animacao, hal_agora());
+        // No modo suave a saída também é renovada entre os passos da animação
+        hal_tempo_t renovacao = suave_renovar(hal_agora());
+        if (renovacao < prazo) {
+            prazo = renovacao;
         }
-        sleep_ms(animation[frame].ms_time);
-    }
-    sleep_ms(100);
-    desligar_leds(pio, sm);
-}
-
-// Função para ligar todos os LEDs na cor azul
-void ligar_azul(PIO pio, uint sm) {
-    // Todos os LEDs acesos com cor azul em intensidade máxima
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t color = rgb_color(0, 0, 1.0); // Azul com intensidade máxima
-        pio_sm_put_blocking(pio, sm, color);  // Envia a cor azul para todos os LEDs
-    }
-}
-
-// Função para ligar todos os LEDs na cor vermelha com 80% de intensidade
-void ligar_vermelho(PIO pio, uint sm) {
-    // Todos os LEDs acesos com cor vermelha em 80% de intensidade
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t color = rgb_color(0.8, 0, 0); // Vermelho com 80% de intensidade
-        pio_sm_put_blocking(pio, sm, color);  // Envia a cor vermelha para todos os LEDs
-    }
-}
-
-void animacao_cobra(PIO pio, uint sm) {
-    // Frames da cobra atravessando a matriz
-    double cobra_frames[20][25] = {
-        {1, 0, 0, 0, 0,  // Primeiro frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 0, 0, 0,  // Segundo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Terceiro frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 1, 1, 1, 0,  // Quarto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 1, 1, 1,  // Quinto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 1, 1,  // Sexto frame
-         1, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 1,  // Sétimo frame
-         1, 0, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Oitavo frame
-         1, 0, 0, 0, 0,
-         0, 0, 0, 1, 1,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Nono frame
-         0, 0, 0, 0, 0,
-         0, 0, 1, 1, 1,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo frame
-         0, 0, 0, 0, 0,
-         0, 1, 1, 1, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Primeiro frame
-         0, 0, 0, 0, 0,
-         1, 1, 1, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Segundo frame
-         0, 0, 0, 0, 0,
-         1, 1, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Terceiro frame
-         0, 0, 0, 0, 0,
-         1, 0, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         1, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Quarto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         1, 1, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Quinto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         1, 1, 1, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Sexto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 1, 1, 1, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Sétimo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 1, 1, 1},
-
-        {0, 0, 0, 0, 0,  // Décimo Oitavo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 1, 1},
-
-        {0, 0, 0, 0, 0,  // Décimo Nono frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 1},
-
-        {0, 0, 0, 0, 0,  // Vigésimo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-    };
-
-    int num_frames = 20; // Número total de frames na animação
-
-    for (int frame = 0; frame < num_frames; frame++) {
-        // Exibe o frame atual
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            if (cobra_frames[frame][i] == 1) {
-                uint32_t color = rgb_color(0, 255, 0); // Cor verde para a cobra
-                pio_sm_put_blocking(pio, sm, color);
-            } else {
-                uint32_t color = rgb_color(0, 0, 0);   // Cor preta (apagado)
-                pio_sm_put_blocking(pio, sm, color);
-            }
+        // Resumo periódico de tempos dos frames (só no build de telemetria)
+        hal_tempo_t resumo = telemetria_relatar(hal_agora());
+        if (resumo < prazo) {
+            prazo = resumo;
         }
-        sleep_ms(200); // Delay entre os frames
-    }
-}
-void animacao_timer(PIO pio, uint sm){
-    
-        double timer_frames [9][25] = {
-        {0, 0, 1, 0, 0,  // Primeiro frame
-         0, 0, 1, 0, 0,
-         0, 0, 1, 0, 0,
-         0, 0, 1, 0, 0,
-         0, 0, 1, 1, 0},
-       
-        {0, 1, 1, 1, 0,  // Segundo frame
-         0, 1, 0, 0, 0,
-         0, 0, 1, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0},    
-        
-        {0, 1, 1, 1, 0,  // terceiro frame
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0},
-        
-        {0, 1, 0, 0, 0,  // Quarto frame
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 0, 1, 0,
-         0, 1, 0, 1, 0},
-        
-        {0, 1, 1, 1, 0,  // Quinto frame
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 0, 0, 0,
-         0, 1, 1, 1, 0},
-
-        {0, 1, 1, 1, 0,  // Sexto frame
-         0, 1, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 0, 0, 0,
-         0, 0, 1, 0, 0},
-
-    
-        
-        {0, 1, 0, 0, 0,  // Setimo frame
-         0, 0, 0, 1, 0,
-         0, 1, 0 , 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0},
-        
-        {0, 1, 1, 1, 0,  // Oitavo frame
-         0, 1, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 0, 1, 0,
-         0, 1, 1, 1, 0},
-        
-        {0, 0, 1, 0, 0,  // 9Sexto frame
-         0, 0, 0, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 0, 1, 0,
-         0, 1, 1, 1, 0},
-        
-    
-      
-    };
-    
-    int total_frames=9;
-
-    for (int frame = 0; frame < total_frames; frame++) {
-        // Exibe o frame atual
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            if (timer_frames[frame][i] == 1) {
-                uint32_t color = rgb_color(255, 0, 0); // Cor vermelha 
-                pio_sm_put_blocking(pio, sm, color);
-            } else {
-                uint32_t color = rgb_color(0, 0, 0);   // Cor preta (apagado)
-                pio_sm_put_blocking(pio, sm, color);
-            }
+        if (!animacao_ativa(&animacao) && !suave_ativo() && !saida_parada) {
+            // A FIFO do PIO precisa estar vazia antes de o núcleo 0 poder mudar o clk_sys
+            framebuffer_aguardar();
+            saida_parada = true;
         }
-        sleep_ms(1000); // Delay entre os frames
-    }
-
-}
-// Animação de "Ondas Crescentes" na matriz de LEDs 5x5
-void animacao_ondas(PIO pio, uint sm) {
-    // Frames representando as ondas crescentes
-    double ondas[6][25] = {
-        {0, 0, 0, 0, 0,  // Nenhum LED aceso (estado inicial)
-         0, 0, 0, 0, 0,
-         0, 0, 1, 0, 0,  // Apenas o LED central aceso
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Primeira expansão
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 0, 0, 0, 1,  // Segunda expansão
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         1, 0, 0, 0, 1},
-
-        {1, 1, 1, 1, 1,  // Terceira expansão (bordas completas)
-         1, 1, 1, 1, 1,
-         1, 1, 1, 1, 1,
-         1, 1, 1, 1, 1,
-         1, 1, 1, 1, 1},
-
-        {0, 0, 0, 0, 0,  // Recolhimento - bordas desligando
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 1, 1, 1, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Última etapa (só o LED central aceso)
-         0, 0, 0, 0, 0,
-         0, 0, 1, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0}
-    };
-
-    int max_frames = 6;  // Número total de frames na animação
+        uso_ocioso();
 
-    // Iteração sobre os frames
-    for (int frame = 0; frame < max_frames; frame++) {
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            if (ondas[frame][i] == 1) {
-                // LEDs acesos com cor azul crescente
-                uint32_t color = rgb_color(0, 0, (double)frame / max_frames);
-                pio_sm_put_blocking(pio, sm, color);
-            } else {
-                // LEDs apagados
-                uint32_t color = rgb_color(0, 0, 0);
-                pio_sm_put_blocking(pio, sm, color);
-            }
-        }
-        sleep_ms(500);  // Delay entre os frames
+        // Um comando novo na FIFO gera um evento que acorda o WFE antes do prazo
+        best_effort_wfe_or_timeout(from_us_since_boot(prazo));
     }
-
-    sleep_ms(100);  // Pausa ao final
-    desligar_leds(pio, sm);  // Garantir que todos os LEDs desliguem
 }
 
-void animacao_e(PIO pio, uint sm){
-        // Frames da cobra atravessando a matriz
-    double e_frames[21][25] = {
-        {1, 0, 0, 0, 0,  // Primeiro frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 0, 0, 0,  // Segundo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Terceiro frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Quarto frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Quinto frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Sexto frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Sétimo frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 0, 0, 0,
-         0, 0, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Oitavo frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 0, 0, 0,
-         0, 1, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Nono frame
-         0, 1, 0, 0, 0,
-         0, 0, 0, 1, 0,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Décimo frame
-         0, 1, 0, 0, 0,
-         1, 0, 0, 1, 0,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Décimo Primeiro frame
-         0, 1, 0, 0, 0,
-         1, 1, 0, 1, 0,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Décimo Segundo frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 0,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-        {1, 1, 1, 0, 0,  // Décimo Terceiro frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 1,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Quarto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Quinto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Sexto frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 1,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-
-        {0, 0, 0, 0, 0,  // Décimo Sétimo frame
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0},
-        
-        {1, 1, 1, 0, 0,  // Décimo Oitavo frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 1,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-         {1, 1, 1, 0, 0,  // Décimo Nono frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 1,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-         {1, 1, 1, 0, 0,  // Vigésimo frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 1,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0},
-
-         {1, 1, 1, 0, 0,  // Vigésimo Primeiro frame
-         0, 1, 0, 0, 0,
-         1, 1, 1, 1, 1,
-         0, 1, 0, 0, 1,
-         0, 1, 1, 0, 0}
-    };
-
-    int num_frames = 22; // Número total de frames na animação
-
-    for (int frame = 0; frame < num_frames; frame++) {
-        // Exibe o frame atual
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            if (e_frames[frame][i] == 1) {
-                uint32_t color = rgb_color(0, 0, 255); // Cor azul para a letra
-                pio_sm_put_blocking(pio, sm, color);
-            } else {
-                uint32_t color = rgb_color(0, 0, 0);   // Cor preta (apagado)
-                pio_sm_put_blocking(pio, sm, color);
-            }
-        }
-        if(frame < 13 || frame > 18){ // Delay entre os frames, dependendo do frame
-            sleep_ms(200);
-        }else{
-            sleep_ms(500);
+#if FLUXO
+// Lê o que chegou pela USB direto para o anel de frames do fluxo
+static void receber_fluxo(void) {
+    while (true) {
+        size_t quanto;
+        uint8_t *destino = fluxo_destino(&quanto);
+        int n = stdio_usb.in_chars((char *)destino, (int)quanto);
+        if (n <= 0) {
+            return;
         }
-    }
-}
-
-
-// uma cobrinha correndo em volta de um led no centro
-void animacao_9(PIO pio,uint sm){
-    double frame[][NUM_PIXELS] = {
-        {1,1,1,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0},
-        {0,1,1,1,1,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0},
-        {0,0,1,1,1,1,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0},
-        {0,0,0,1,1,1,0,0,0,0,0,0,1,0,1,0,0,0,0,0,0,0,0,0,0},
-        {0,0,0,0,1,1,0,0,0,0,0,0,1,0,1,1,0,0,0,0,0,0,0,0,0},
-        {0,0,0,0,0,1,0,0,0,0,0,0,1,0,1,1,0,0,0,0,0,0,0,0,1},
-        {0,0,0,0,0,0,0,0,0,0,0,0,1,0,1,1,0,0,0,0,0,0,0,1,1},
-        {0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,0,1,1,1},
-        {0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,1,1,1},
-        {0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,0,1,1,1,1,0},
-        {0,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,0,1,1,1,1,0,0},
-        {0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0,0,1,1,1,0,0,0},
-        {0,0,0,0,0,0,0,0,0,1,1,0,1,0,0,0,0,0,0,1,0,0,0,0,0},
-        {1,0,0,0,0,0,0,0,0,1,1,0,1,0,0,0,0,0,0,1,0,0,0,0,0},
-        {1,1,0,0,0,0,0,0,0,1,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0},
-        {1,1,1,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0}
-    };
-    int num_frames = 16;
-    int k = 0;
-    while (k < 7){
-        for (int j = 0; j < num_frames; j++) {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                if (frame[j][i]) {
-                    uint32_t color = rgb_color(0.2, 0, 0);
-                    pio_sm_put_blocking(pio, sm, color);
-                } else {
-                    uint32_t color = rgb_color(0, 0, 0);
-                    pio_sm_put_blocking(pio, sm, color);
-                }
-            }
-            sleep_ms(50);
+        if (fluxo_recebido(n)) {
+            __sev(); // Acorda o núcleo 1 se ele estiver esperando a fila encher
         }
-        k++;
     }
-    desligar_leds(pio, sm);
 }
-
+#endif
 
 // Função principal
 int main() {
     stdio_init_all();
 
     // Inicializa PIO e configura
-    PIO pio = pio0;
-    uint offset = pio_add_program(pio, &pio_matrix_program);
-    uint sm = pio_claim_unused_sm(pio, true);
-    pio_matrix_program_init(pio, sm, offset, OUT_PIN);
-
-    // Inicializa teclado
-    init_gpio();
+    pio_saida = pio0;
+    sm_saida = pio_claim_unused_sm(pio_saida, true);
+#if TELA_FAIXAS > 1
+    uint offset = pio_add_program(pio_saida, &pio_matrix_paralelo_program);
+    pio_matrix_paralelo_program_init(pio_saida, sm_saida, offset, tela.pino, tela.faixas);
+#else
+    uint offset = pio_add_program(pio_saida, &pio_matrix_program);
+    pio_matrix_program_init(pio_saida, sm_saida, offset, tela.pino);
+#endif
+
+    // Renderização e envio dos frames ficam no núcleo 1
+    latencia_init();
+    multicore_launch_core1(nucleo1_main);
+
+    // Inicializa teclado: a varredura e o debounce rodam no pio1
+    teclado_init(pio1);
 
     printf("Sistema iniciado.\n");
+    printf("Tela: %ux%u pixels (%ux%u paineis de %ux%u) em %u faixa(s), ate %u frames/s\n",
+           TELA_LARGURA, TELA_ALTURA, tela.paineis_x, tela.paineis_y, tela.painel_largura, tela.painel_altura,
+           tela.faixas, FRAMEBUFFER_FPS_MAX(TELA_PIXELS_POR_FAIXA));
 
-    while (true) {
-        char tecla = escanear_teclado();
-        switch (tecla)
-        {
-        case '1':
-            animacao_1(pio, sm); // Simboliza o carregamento de uma bateria
-            break;
-            
-        case '2':
-            animacao_2(pio, sm); // Simboliza um X na matriz
-            break;
-
-        case '3':
-            animacao_cobra(pio, sm); // Simboliza uma cobra atravessando a matriz
-            break;   
-        case '4':
-            animacao_timer(pio, sm); // Simboliza um timer de 1 a 9
-            break;
-            
-        case '5':
-            animacao_e(pio, sm); // Letra 'e' da embarcatech aparece
-            break;
-
-        case '6':
-            animacao_ondas(pio, sm); // Simboliza ondas crescentes
-            break;
-            
-        case '9':
-            animacao_9(pio, sm);
-            break;
-
-        case '0':
-            animacao_0(pio, sm); // rosto feliz piscando
-            break;
-
-        case 'A':
-            desligar_leds(pio, sm);
-            break;
-
-        case 'B':
-            ligar_azul(pio, sm);
-            break;
-
-        case 'C':
-            ligar_vermelho(pio, sm); // Aciona LEDs na cor vermelha com 80% de intensidade
-            break;
+    // O núcleo 0 só lê o teclado e produz comandos
+    absolute_time_t leitura = get_absolute_time();
+    absolute_time_t ultima_tecla = leitura;
+    absolute_time_t relatorio = make_timeout_time_ms(RELATORIO_USO_MS);
 
-        case 'D': // liga os leds em verde com 50% de intensidade
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color = rgb_color(0, 0.5, 0); // verde com 50% de intensidade
-                pio_sm_put_blocking(pio, sm, color); 
+    while (true) {
+        uso_ocupado();
+        teclado_evento_t evento;
+        while (teclado_evento(&evento)) {
+            ultima_tecla = get_absolute_time();
+            // Só a borda de pressionar conta (segurar a tecla não reinicia a animação)
+            if (!evento.pressionada) {
+                continue;
             }
-            break;  
-
-        case '#': // liga leds com cor branca em 20% de intensidade
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color = rgb_color(0.2, 0.2, 0.2); // branco com 20% de intensidade
-                pio_sm_put_blocking(pio, sm, color); 
+            animacao_passo_t comando = comando_da_tecla(evento.tecla);
+            latencia_tecla(comando ? evento.tecla : 0);
+            if (comando) {
+                multicore_fifo_push_blocking((uint32_t)comando);
+                multicore_fifo_push_blocking((uint32_t)time_us_64());
             }
-            break;
-        default:
-            break;
         }
-        sleep_ms(100); // Debounce
+        if (teclado_livre()) {
+            latencia_armar(time_us_64());
+        }
+#if FLUXO
+        receber_fluxo();
+#elif GRAVADOR
+        // Sem o fluxo, a entrada da USB só traz o pedido de despejo
+        if (getchar_timeout_us(0) == 'G') {
+            gravador_despejar();
+        }
+#endif
+
+        if (time_reached(relatorio)) {
+            relatorio = delayed_by_ms(relatorio, RELATORIO_USO_MS);
+            uint uso0 = uso_percentual(0);
+            uint uso1 = uso_percentual(1);
+            printf("Uso: nucleo 0 %u%%, nucleo 1 %u%%\n", uso0, uso1);
+            printf("Despertar ate o primeiro frame: ultimo %lu us, maximo %lu us\n",
+                   (unsigned long)ocioso_despertar_us(), (unsigned long)ocioso_despertar_max_us());
+            framebuffer_estatisticas_t saida;
+            framebuffer_estatisticas(&saida);
+            printf("Frames: %lu enviados, %lu repetidos pulados (%lu us de barramento economizados)\n",
+                   (unsigned long)saida.enviados, (unsigned long)saida.pulados, (unsigned long)saida.us_economizados);
+            suave_estatisticas_t suave;
+            suave_estatisticas(&suave);
+            printf("Suave: %lu renovacoes (%lu atrasadas), mistura ultima %lu us, maxima %lu us de %u us\n",
+                   (unsigned long)suave.renovacoes, (unsigned long)suave.atrasadas, (unsigned long)suave.us_ultimo,
+                   (unsigned long)suave.us_maximo, 1000000 / SUAVE_HZ);
+            comandos_estatisticas_t comandos = fila.estatisticas;
+            printf("Comandos: %lu recebidos, %lu executados, %lu combinados, %lu descartados, fila maxima %lu, "
+                   "espera maxima %lu us\n",
+                   (unsigned long)comandos.recebidos, (unsigned long)comandos.executados,
+                   (unsigned long)comandos.combinados, (unsigned long)comandos.descartados,
+                   (unsigned long)comandos.profundidade_max, (unsigned long)comandos.espera_max_us);
+            latencia_relatar();
+#if GRAVADOR
+            gravador_estatisticas_t gravador;
+            gravador_estatisticas(&gravador);
+            printf("Gravador: %lu frames (%lu completos), %lu bytes, %lu sobrescritos, %lu ignorados, "
+                   "ultimo %lu us, maximo %lu us\n",
+                   (unsigned long)gravador.frames, (unsigned long)gravador.chaves, (unsigned long)gravador.bytes,
+                   (unsigned long)gravador.sobrescritos, (unsigned long)gravador.ignorados,
+                   (unsigned long)gravador.us_ultimo, (unsigned long)gravador.us_maximo);
+#endif
+#if FLUXO
+            fluxo_estatisticas_t fluxo;
+            fluxo_estatisticas(&fluxo);
+            printf("Fluxo: %lu recebidos, %lu exibidos, %lu descartados, %lu atrasados, %lu perdidos, %lu corrompidos\n",
+                   (unsigned long)fluxo.recebidos, (unsigned long)fluxo.exibidos, (unsigned long)fluxo.descartados,
+                   (unsigned long)fluxo.atrasados, (unsigned long)fluxo.perdidos, (unsigned long)fluxo.corrompidos);
+#endif
+        }
+
+        // Nada acontecendo: dorme até uma tecla em vez de continuar lendo a FIFO do teclado
+        if (saida_parada && teclado_livre() &&
+            absolute_time_diff_us(ultima_tecla, get_absolute_time()) >= OCIOSO_APOS_MS * 1000) {
+            uso_ocioso();
+            // Mesmo quando não chega a dormir (tecla já pressionada), a varredura
+            // recomeçou e precisa de tempo para entregar o evento
+            ocioso_dormir(pio_saida, sm_saida);
+            leitura = get_absolute_time();
+            ultima_tecla = leitura;
+            continue;
+        }
+        uso_ocioso();
+
+        leitura = delayed_by_ms(leitura, LEITURA_MS);
+        sleep_until(leitura);
     }
 }
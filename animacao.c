@@ -0,0 +1,43 @@
+#include "animacao.h"
+#include "telemetria.h"
+
+void animacao_iniciar(animacao_t *a, animacao_passo_t passo, hal_tempo_t agora) {
+    a->passo = passo;
+    a->proximo = 0;
+    a->prazo = agora;
+}
+
+void animacao_parar(animacao_t *a) {
+    a->passo = NULL;
+}
+
+bool animacao_ativa(const animacao_t *a) {
+    return a->passo != NULL;
+}
+
+hal_tempo_t animacao_executar(animacao_t *a, hal_tempo_t agora) {
+    if (!a->passo) {
+        return HAL_TEMPO_INFINITO;
+    }
+    if (agora < a->prazo) {
+        return a->prazo;
+    }
+
+#if TELEMETRIA
+    animacao_passo_t passo = a->passo;
+    hal_tempo_t inicio = hal_agora();
+#endif
+    uint32_t ms = a->passo(a->proximo++);
+#if TELEMETRIA
+    telemetria_passo(passo, a->prazo, inicio, hal_agora());
+#endif
+    if (ms == ANIMACAO_FIM) {
+        a->passo = NULL;
+        return HAL_TEMPO_INFINITO;
+    }
+
+    // Prazo contado a partir do prazo anterior, não de 'agora': o tempo gasto
+    // desenhando e enviando o frame não se acumula ao longo da animação
+    a->prazo += (hal_tempo_t)ms * 1000;
+    return a->prazo;
+}
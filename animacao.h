@@ -0,0 +1,32 @@
+#ifndef ANIMACAO_H
+#define ANIMACAO_H
+
+#include "hal.h"
+
+// Retorno de um passo que encerra a animação (o que ele desenhou continua na tela)
+#define ANIMACAO_FIM 0
+
+// Desenha o passo indicado e devolve por quantos ms ele fica na tela,
+// ou ANIMACAO_FIM quando a animação acabou
+typedef uint32_t (*animacao_passo_t)(uint32_t passo);
+
+// Estado de uma animação em execução
+typedef struct {
+    animacao_passo_t passo;
+    uint32_t proximo;       // Índice do próximo passo
+    hal_tempo_t prazo;      // Instante absoluto em que o próximo passo deve ser desenhado
+} animacao_t;
+
+// Começa uma animação (substitui a atual); o primeiro passo sai na próxima chamada de animacao_executar
+void animacao_iniciar(animacao_t *a, animacao_passo_t passo, hal_tempo_t agora);
+
+// Interrompe a animação atual, deixando na tela o último frame enviado
+void animacao_parar(animacao_t *a);
+
+bool animacao_ativa(const animacao_t *a);
+
+// Desenha o passo vencido, se houver, e devolve o prazo do próximo
+// (HAL_TEMPO_INFINITO quando não há animação)
+hal_tempo_t animacao_executar(animacao_t *a, hal_tempo_t agora);
+
+#endif
@@ -0,0 +1,374 @@
+#include "animacoes.h"
+#include "framebuffer.h"
+#include "frames.h"
+#include "cor.h"
+#include "compacta.h"
+#include "tela.h"
+#include "efeitos.h"
+#include "suave.h"
+#include "fluxo.h"
+#include "fio.h"
+#include "camadas.h"
+#include "texto.h"
+
+// Painel em que as animações 5x5 são desenhadas (só muda no núcleo 1)
+static uint painel_alvo = 0;
+
+// Modo suave (ver suave.h): os frames-chave das animações são desenhados em RGB
+// de autoria num buffer próprio e a saída faz a transição até cada um
+static bool modo_suave = false;
+static uint32_t chave[NUM_PIXELS];
+
+// Funções auxiliares
+// Desenha um frame no painel alvo e apaga o resto da tela
+static void desenhar_frame(uint32_t *pixels, frame_t frame, uint32_t cor) {
+    if (NUM_PIXELS > FRAME_PIXELS) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            pixels[i] = 0;
+        }
+    }
+    int x, y;
+    tela_origem_painel(&tela, painel_alvo % tela.paineis_x, painel_alvo / tela.paineis_x, &x, &y);
+    tela_desenhar_frame(&tela, pixels, x, y, frame, cor);
+}
+
+// Desenha um frame no painel alvo com a cor dada, apaga o resto da tela e envia via DMA
+void mostrar_frame(frame_t frame, uint32_t cor) {
+    suave_parar();
+    desenhar_frame(framebuffer_desenho(), frame, cor);
+    framebuffer_mostrar();
+}
+
+// Frame-chave de uma animação: buffer e cor (RGB) para desenhar, depois a entrega,
+// que no modo suave vira uma transição de 'ms' até ele
+static uint32_t *chave_desenho(void) {
+    return modo_suave ? chave : framebuffer_desenho();
+}
+
+static uint32_t chave_cor(uint32_t rgb) {
+    return modo_suave ? rgb : cor_grb(rgb);
+}
+
+static void chave_mostrar(uint32_t ms) {
+    if (modo_suave) {
+        suave_chave(chave, ms, hal_agora());
+    } else {
+        framebuffer_mostrar();
+    }
+}
+
+// Preenche todos os LEDs com a mesma cor e envia via DMA
+void preencher_leds(uint32_t cor) {
+    suave_parar();
+    uint32_t *pixels = framebuffer_desenho();
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pixels[i] = cor;
+    }
+    framebuffer_mostrar();
+}
+
+// Toca uma animação compactada, um frame por passo, na cor e duração gravadas nela.
+// Com a tabela do fio (ver fio.h), o frame sai direto dela, sem ser desenhado.
+static uint32_t tocar_compacta(const compacta_t *animacao, const fio_tabela_t *fio, uint32_t passo) {
+    // Só uma animação roda por vez no núcleo 1, então um leitor basta
+    static compacta_leitor_t leitor;
+    if (passo == 0) {
+        compacta_iniciar(&leitor, animacao);
+    }
+    if (!compacta_proximo(&leitor)) {
+        return ANIMACAO_FIM;
+    }
+    // A tabela do fio é indexada pelo frame da compacta: só serve se as duas batem
+    if (fio && fio->num_frames == animacao->num_frames && !modo_suave && cor_brilho() == 255) {
+        // O frame apagado do fim fica depois dos frames da volta
+        uint i = leitor.fim ? fio->num_frames : leitor.frame - 1;
+        framebuffer_mostrar_buffer(fio->palavras[fio->indice[i]]);
+    } else {
+        desenhar_frame(chave_desenho(), leitor.atual, chave_cor(leitor.cor));
+        chave_mostrar(leitor.ms);
+    }
+    return leitor.ms; // 0 (ANIMACAO_FIM) no frame apagado do fim
+}
+
+// Animações do teclado, geradas a partir de animacoes/*.anim durante o build
+#include "animacoes_geradas.h"
+
+// Indica se o efeito já passou do último passo; nesse caso apaga a tela, se ele apaga no fim
+static bool efeito_acabou(const efeito_t *e, uint32_t passo) {
+    if (passo < e->tipo->passos(e)) {
+        return false;
+    }
+    if (e->apagar_no_fim) {
+        desligar_leds();
+    }
+    return true;
+}
+
+// Mostra o passo já desenhado no buffer de desenho e retorna a duração dele
+static uint32_t mostrar_passo(const efeito_t *e) {
+    chave_mostrar(e->ms);
+    return e->ms;
+}
+
+// Toca um efeito procedural, um passo por vez, com a cor interpolada ao longo dele
+static uint32_t tocar_efeito(const efeito_t *e, uint32_t passo) {
+    if (efeito_acabou(e, passo)) {
+        return ANIMACAO_FIM;
+    }
+    uint32_t cor = cor_interpolar(e->cor, e->cor_final, passo, e->tipo->passos(e));
+    e->tipo->desenhar(e, chave_desenho(), passo, chave_cor(cor));
+    return mostrar_passo(e);
+}
+
+// Bateria carregando, com transição de vermelho para verde
+uint32_t animacao_1(uint32_t passo) {
+    static const efeito_t barra = {
+        .tipo = &efeito_barra, .cor = RGB(255, 0, 0), .cor_final = RGB(0, 255, 0), .ms = 100,
+    };
+    return tocar_efeito(&barra, passo);
+}
+
+// Cobra atravessando a tela em zigue-zague
+uint32_t animacao_cobra(uint32_t passo) {
+    static const efeito_t cobra = {
+        .tipo = &efeito_cobra, .cor = RGB(0, 255, 0), .cor_final = RGB(0, 255, 0), .ms = 200,
+        .comprimento = 3, .caminho = efeito_caminho_zigue_zague,
+    };
+    return tocar_efeito(&cobra, passo);
+}
+
+// Ondas saindo do centro, com o azul aumentando a cada passo
+uint32_t animacao_ondas(uint32_t passo) {
+    static const efeito_t ondas = {
+        .tipo = &efeito_aneis, .cor = RGB(0, 0, 42), .cor_final = RGB(0, 0, 255), .ms = 500,
+        .comprimento = 2, .apagar_no_fim = true,
+    };
+    return tocar_efeito(&ondas, passo);
+}
+
+// Cobrinha dando 7 voltas pela borda, em volta de um LED no centro. São duas
+// camadas: a cobra e, por cima dela, o centro.
+uint32_t animacao_9(uint32_t passo) {
+    static const efeito_t cobrinha = {
+        .tipo = &efeito_cobra, .cor = RGB(51, 0, 0), .cor_final = RGB(51, 0, 0), .ms = 50,
+        .comprimento = 4, .voltas = 7, .caminho = efeito_caminho_borda, .apagar_no_fim = true,
+    };
+    static uint32_t cobra[NUM_PIXELS];
+    static uint32_t centro[NUM_PIXELS];
+    if (efeito_acabou(&cobrinha, passo)) {
+        return ANIMACAO_FIM;
+    }
+
+    uint32_t cor = chave_cor(cobrinha.cor);
+    cobrinha.tipo->desenhar(&cobrinha, cobra, passo, cor);
+    centro[tela_indice(&tela, (TELA_LARGURA - 1) / 2, (TELA_ALTURA - 1) / 2)] = cor;
+    const camada_t camadas[] = {
+        {.pixels = cobra, .modo = CAMADA_MAXIMO, .alfa = CAMADA_OPACA},
+        {.pixels = centro, .modo = CAMADA_ALFA, .alfa = CAMADA_OPACA},
+    };
+    camadas_compor(chave_desenho(), camadas, count_of(camadas));
+    return mostrar_passo(&cobrinha);
+}
+
+static void apagar_tela(uint32_t *pixels) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pixels[i] = 0;
+    }
+}
+
+// Timer de 1 a 9, um dígito por segundo no centro do painel alvo
+uint32_t animacao_timer(uint32_t passo) {
+    if (passo >= 9) {
+        return ANIMACAO_FIM;
+    }
+    const char digito[] = {'1' + passo, 0};
+    uint32_t *pixels = chave_desenho();
+    apagar_tela(pixels);
+    int x, y;
+    tela_origem_painel(&tela, painel_alvo % tela.paineis_x, painel_alvo / tela.paineis_x, &x, &y);
+    texto_desenhar(pixels, digito, x + (FRAME_LADO - (int)texto_largura(digito)) / 2, y, chave_cor(RGB(255, 0, 0)));
+    chave_mostrar(1000);
+    return 1000;
+}
+
+// Mensagem rolando por toda a largura da tela, na linha de painéis do painel alvo
+uint32_t animacao_letreiro(uint32_t passo) {
+    // Só uma animação roda por vez no núcleo 1, então um letreiro basta
+    static texto_letreiro_t letreiro;
+    if (passo == 0) {
+        texto_letreiro_iniciar(&letreiro, "EMBARCATECH");
+    }
+    if (!texto_letreiro_avancar(&letreiro)) {
+        return ANIMACAO_FIM; // A última coluna já saiu: a tela está apagada
+    }
+    uint32_t *pixels = chave_desenho();
+    if (TELA_PAINEIS_Y > 1) {
+        apagar_tela(pixels);
+    }
+    int x, y;
+    tela_origem_painel(&tela, 0, painel_alvo / tela.paineis_x, &x, &y);
+    texto_letreiro_desenhar(&letreiro, pixels, y, chave_cor(RGB(0, 128, 255)));
+    chave_mostrar(120);
+    return 120;
+}
+
+// Função para desligar todos os LEDs
+void desligar_leds() {
+    // Todos os LEDs desligados (cor preta)
+    preencher_leds(0);
+}
+
+// Modos de cor fixa: animações de um único passo, que também interrompem a anterior
+uint32_t modo_desligar(uint32_t passo) {
+    (void)passo;
+    desligar_leds();
+    return ANIMACAO_FIM;
+}
+
+// Função para ligar todos os LEDs na cor azul
+uint32_t ligar_azul(uint32_t passo) {
+    (void)passo;
+    // Todos os LEDs acesos com cor azul em intensidade máxima
+    preencher_leds(cor_rgb(0, 0, 255));
+    return ANIMACAO_FIM;
+}
+
+// Função para ligar todos os LEDs na cor vermelha com 80% de intensidade
+uint32_t ligar_vermelho(uint32_t passo) {
+    (void)passo;
+    // Todos os LEDs acesos com cor vermelha em 80% de intensidade
+    preencher_leds(cor_rgb_q8(Q8(0.8), 0, 0));
+    return ANIMACAO_FIM;
+}
+
+// Função para ligar todos os LEDs na cor verde com 50% de intensidade
+uint32_t ligar_verde(uint32_t passo) {
+    (void)passo;
+    preencher_leds(cor_rgb_q8(0, Q8(0.5), 0));
+    return ANIMACAO_FIM;
+}
+
+// Função para ligar todos os LEDs na cor branca com 20% de intensidade
+uint32_t ligar_branco(uint32_t passo) {
+    (void)passo;
+    preencher_leds(cor_rgb_q8(Q8(0.2), Q8(0.2), Q8(0.2)));
+    return ANIMACAO_FIM;
+}
+
+// Passa as próximas animações para o painel seguinte da tela (da esquerda para
+// a direita, de cima para baixo), voltando ao primeiro depois do último
+uint32_t proximo_painel(uint32_t passo) {
+    (void)passo;
+    painel_alvo = (painel_alvo + 1) % (tela.paineis_x * tela.paineis_y);
+    desligar_leds();
+    return ANIMACAO_FIM;
+}
+
+// Liga e desliga o modo suave para as próximas animações
+uint32_t alternar_suave(uint32_t passo) {
+    (void)passo;
+    modo_suave = !modo_suave;
+    return ANIMACAO_FIM;
+}
+
+// Reproduz os frames recebidos pela USB, cada um pelo tempo indicado no pacote.
+// Enquanto a fila enche o último frame continua nos LEDs.
+uint32_t modo_fluxo(uint32_t passo) {
+    if (passo == 0) {
+        // Os frames que chegaram antes do modo são velhos; o que está no DMA
+        // precisa terminar de sair antes de o lugar dele ser reaproveitado
+        suave_parar();
+        framebuffer_aguardar();
+        fluxo_reiniciar();
+    }
+    const fluxo_quadro_t *q = fluxo_proximo();
+    if (!q) {
+        return FLUXO_ESPERA_MS;
+    }
+    framebuffer_mostrar_buffer(q->pixels);
+    uint32_t ms = q->ms;
+    fluxo_avancar();
+    return ms;
+}
+
+// Só os modos que mudam estado escapam da regra de tela: o suave liga e desliga
+// e o painel avança a cada vez (o frame apagado dele é substituído sem perda)
+comando_tipo_t comando_tipo(animacao_passo_t comando) {
+    if (comando == alternar_suave) {
+        return COMANDO_ALTERNAR;
+    }
+    if (comando == proximo_painel) {
+        return COMANDO_ACUMULAR;
+    }
+    return COMANDO_TELA;
+}
+
+// Tecla que produz o comando, ou 0 se nenhuma (para relatórios)
+char tecla_do_comando(animacao_passo_t comando) {
+    for (const char *t = "0123456789ABCD*#"; *t; t++) {
+        if (comando_da_tecla(*t) == comando) {
+            return *t;
+        }
+    }
+    return 0;
+}
+
+// Traduz a tecla no comando enviado ao núcleo 1 (o passo da animação a iniciar), ou NULL se não houver
+animacao_passo_t comando_da_tecla(char tecla) {
+    switch (tecla)
+    {
+    case '1':
+        return animacao_1; // Simboliza o carregamento de uma bateria
+        
+    case '2':
+        return animacao_2; // Simboliza um X na matriz
+
+    case '3':
+        return animacao_cobra; // Simboliza uma cobra atravessando a matriz
+    case '4':
+        return animacao_timer; // Simboliza um timer de 1 a 9
+        
+    case '5':
+        return animacao_e; // Letra 'e' da embarcatech aparece
+
+    case '6':
+        return animacao_ondas; // Simboliza ondas crescentes
+        
+    case '9':
+        return animacao_9;
+
+    case '0':
+        return animacao_0; // rosto feliz piscando
+
+    case 'A':
+        return modo_desligar;
+
+    case 'B':
+        return ligar_azul;
+
+    case 'C':
+        return ligar_vermelho; // Aciona LEDs na cor vermelha com 80% de intensidade
+
+    case 'D': // liga os leds em verde com 50% de intensidade
+        return ligar_verde;
+
+    case '#': // liga leds com cor branca em 20% de intensidade
+        return ligar_branco;
+
+    case '*': // próximo painel, quando há mais de um
+        return proximo_painel;
+
+    case '8': // transições suaves entre os frames das animações
+        return alternar_suave;
+
+#if FLUXO
+    case '7': // frames recebidos pela USB
+        return modo_fluxo;
+#else
+    case '7': // mensagem rolando pela tela
+        return animacao_letreiro;
+#endif
+    default:
+        return NULL;
+    }
+}
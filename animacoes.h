@@ -0,0 +1,52 @@
+#ifndef ANIMACOES_H
+#define ANIMACOES_H
+
+#include "animacao.h"
+#include "frames.h"
+#include "comandos.h"
+
+// Desenha um frame no painel alvo com a cor dada e envia
+void mostrar_frame(frame_t frame, uint32_t cor);
+
+// Preenche todos os LEDs com a mesma cor e envia
+void preencher_leds(uint32_t cor);
+
+void desligar_leds();
+
+// Passos das animações do teclado (ver animacao_passo_t)
+uint32_t animacao_0(uint32_t passo);
+uint32_t animacao_1(uint32_t passo);
+uint32_t animacao_2(uint32_t passo);
+uint32_t animacao_cobra(uint32_t passo);
+uint32_t animacao_timer(uint32_t passo);
+uint32_t animacao_ondas(uint32_t passo);
+uint32_t animacao_e(uint32_t passo);
+uint32_t animacao_9(uint32_t passo);
+uint32_t animacao_letreiro(uint32_t passo);
+
+// Modos de cor fixa, com um único passo
+uint32_t modo_desligar(uint32_t passo);
+uint32_t ligar_azul(uint32_t passo);
+uint32_t ligar_vermelho(uint32_t passo);
+uint32_t ligar_verde(uint32_t passo);
+uint32_t ligar_branco(uint32_t passo);
+
+// Muda o painel alvo das animações 5x5 para o próximo da tela
+uint32_t proximo_painel(uint32_t passo);
+
+// Liga e desliga as transições suaves entre frames (ver suave.h)
+uint32_t alternar_suave(uint32_t passo);
+
+// Frames ao vivo recebidos pela USB (ver fluxo.h), até outro comando
+uint32_t modo_fluxo(uint32_t passo);
+
+// Traduz a tecla no comando enviado ao núcleo 1 (o passo da animação a iniciar), ou NULL se não houver
+animacao_passo_t comando_da_tecla(char tecla);
+
+// Como o comando se combina com outros na fila do núcleo 1 (ver comandos.h)
+comando_tipo_t comando_tipo(animacao_passo_t comando);
+
+// Tecla que produz o comando, ou 0 se nenhuma (para relatórios)
+char tecla_do_comando(animacao_passo_t comando);
+
+#endif
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+"""Compila as animações em arte ASCII (animacoes/*.anim) para tabelas compacta_t.
+
+Formato de um arquivo .anim (uma animação por arquivo; o nome do arquivo dá o
+nome da função, animacao_<nome>):
+
+    // comentário
+    cor 0 0 128      cor RGB de 8 bits dos frames seguintes
+    ms 500           duração dos frames seguintes
+    repetir 7        toca a animação inteira 7 vezes (opcional)
+    apagar           apaga a matriz depois do último frame (opcional)
+
+    .....            frame: 5 linhas de 5 caracteres, '#' aceso e '.' apagado,
+    .###.            desenhado como é visto na matriz (linha de cima primeiro)
+    .....
+    .....
+    .#.#.
+
+O compilador converte cada pixel para a ordem do fio (a matriz começa no canto
+inferior direito e as linhas alternam de sentido) e escolhe, frame a frame, o
+registro mais curto: delta em relação ao anterior ou referência a um frame-chave.
+Qualquer erro de formato interrompe o build.
+
+Na segunda saída vão os mesmos frames sem compactação (máscara e cor de cada
+um), que fio.cpp expande no build nas palavras enviadas ao pio_matrix.
+
+Uso: compilar.py <saida.h> <saida_fio.h> <arquivo.anim>...
+"""
+
+import os
+import sys
+
+LADO = 5
+NUM_PIXELS = LADO * LADO
+MAX_CHAVES = 32
+MAX_DELTA = 31
+MAX_FRAMES = 255  # FIO_MAX_FRAMES em fio.h
+
+C_COM_COR = 0x80
+C_CHAVE = 0x40
+C_COM_MS = 0x20
+
+
+class ErroAnimacao(Exception):
+    pass
+
+
+def indice_no_fio(linha, coluna):
+    # Linha 0 do fio é a de baixo; as linhas pares do fio andam da direita para a esquerda
+    linha_fio = LADO - 1 - linha
+    coluna_fio = LADO - 1 - coluna if linha_fio % 2 == 0 else coluna
+    return linha_fio * LADO + coluna_fio
+
+
+def ler(caminho):
+    frames = []  # (mascara, cor, ms, arte)
+    cor = None
+    ms = None
+    repetir = 1
+    apagar = False
+    grade = []
+
+    def erro(num, msg):
+        raise ErroAnimacao("%s:%d: %s" % (caminho, num, msg))
+
+    with open(caminho, encoding="utf-8") as f:
+        linhas = f.read().splitlines()
+
+    for num, texto in enumerate(linhas + [""], 1):
+        texto = texto.split("//", 1)[0].strip()
+        campos = texto.split()
+
+        if texto and set(texto) <= set(".#"):
+            if len(texto) != LADO:
+                erro(num, "linha de frame com %d colunas (esperado %d)" % (len(texto), LADO))
+            grade.append(texto)
+            if len(grade) == LADO:
+                if cor is None or ms is None:
+                    erro(num, "frame sem 'cor' ou 'ms' definidos antes")
+                mascara = 0
+                for l, linha in enumerate(grade):
+                    for c, pixel in enumerate(linha):
+                        if pixel == "#":
+                            mascara |= 1 << indice_no_fio(l, c)
+                frames.append((mascara, cor, ms, list(grade)))
+                grade = []
+            continue
+
+        if grade:
+            erro(num, "frame incompleto: %d de %d linhas" % (len(grade), LADO))
+        if not campos:
+            continue
+
+        try:
+            if campos[0] == "cor" and len(campos) == 4:
+                r, g, b = (int(x) for x in campos[1:])
+                if not all(0 <= x <= 255 for x in (r, g, b)):
+                    erro(num, "canal de cor fora de 0..255")
+                cor = (r, g, b)
+            elif campos[0] == "ms" and len(campos) == 2:
+                ms = int(campos[1])
+                if not 1 <= ms <= 0xFFFF:
+                    erro(num, "duração fora de 1..65535 ms")
+            elif campos[0] == "repetir" and len(campos) == 2:
+                repetir = int(campos[1])
+                if not 1 <= repetir <= 255:
+                    erro(num, "repetir fora de 1..255")
+            elif campos[0] == "apagar" and len(campos) == 1:
+                apagar = True
+            else:
+                erro(num, "diretiva desconhecida: %s" % texto)
+        except ValueError:
+            erro(num, "número inválido: %s" % texto)
+
+    if not frames:
+        raise ErroAnimacao("%s: nenhum frame" % caminho)
+    return frames, repetir, apagar
+
+
+def compilar(frames, repetir):
+    if len(frames) > MAX_FRAMES:
+        raise ErroAnimacao("mais de %d frames" % MAX_FRAMES)
+    chaves = []
+    dados = []  # (bytes, comentário)
+    anterior = 0
+    cor_anterior = None
+    ms_anterior = None
+
+    for i, (mascara, cor, ms, arte) in enumerate(frames):
+        cab = 0
+        if cor != cor_anterior:
+            cab |= C_COM_COR
+        if ms != ms_anterior:
+            cab |= C_COM_MS
+
+        alterados = [p for p in range(NUM_PIXELS) if (mascara ^ anterior) >> p & 1]
+        # Ao repetir, o primeiro frame não pode depender do último da volta anterior
+        pode_delta = not (i == 0 and repetir > 1) and len(alterados) <= MAX_DELTA
+        custo_chave = 1 if mascara in chaves else 1 + 4
+        if pode_delta and 1 + len(alterados) <= custo_chave:
+            cab |= len(alterados)
+            tipo = "C_DELTA(%d)" % len(alterados)
+            indices = alterados
+        else:
+            if mascara not in chaves:
+                if len(chaves) == MAX_CHAVES:
+                    raise ErroAnimacao("mais de %d frames-chave" % MAX_CHAVES)
+                chaves.append(mascara)
+            cab |= C_CHAVE | chaves.index(mascara)
+            tipo = "C_CHAVE(%d)" % chaves.index(mascara)
+            indices = []
+
+        partes = [tipo]
+        if cab & C_COM_COR:
+            partes[0] += " | C_COM_COR"
+        if cab & C_COM_MS:
+            partes[0] += " | C_COM_MS"
+        if cab & C_COM_MS:
+            partes.append("C_MS(%d)" % ms)
+        if cab & C_COM_COR:
+            partes.append("C_COR(%d, %d, %d)" % cor)
+        partes += [str(p) for p in indices]
+        dados.append((", ".join(partes), "frame %d: %s" % (i, " ".join(arte))))
+
+        anterior = mascara
+        cor_anterior = cor
+        ms_anterior = ms
+
+    return chaves, dados
+
+
+def gerar(saida, saida_fio, arquivos):
+    nomes = []
+    blocos = []
+    blocos_fio = []
+    for caminho in sorted(arquivos):
+        nome = os.path.splitext(os.path.basename(caminho))[0]
+        if not nome.replace("_", "").isalnum():
+            raise ErroAnimacao("%s: nome inválido para uma função C" % caminho)
+        frames, repetir, apagar = ler(caminho)
+        try:
+            chaves, dados = compilar(frames, repetir)
+        except ErroAnimacao as e:
+            raise ErroAnimacao("%s: %s" % (caminho, e))
+
+        fonte = "animacoes/" + os.path.basename(caminho)
+        b = ["// %s: %d frames" % (fonte, len(frames))]
+        if chaves:
+            b.append("static const frame_t animacao_%s_chaves[] = {" % nome)
+            b += ["    0x%07x," % m for m in chaves]
+            b.append("};")
+        b.append("static const uint8_t animacao_%s_dados[] = {" % nome)
+        b += ["    %s, // %s" % (d, c) for d, c in dados]
+        b.append("};")
+        b.append("static const compacta_t animacao_%s_tabela = {" % nome)
+        b.append("    .chaves = %s," % ("animacao_%s_chaves" % nome if chaves else "NULL"))
+        b.append("    .dados = animacao_%s_dados," % nome)
+        b.append("    .tamanho = sizeof(animacao_%s_dados)," % nome)
+        b.append("    .num_frames = %d," % len(frames))
+        b.append("    .repeticoes = %d," % repetir)
+        b.append("    .apagar_no_fim = %s," % ("true" if apagar else "false"))
+        b.append("};")
+        if chaves:
+            b.append("_Static_assert(count_of(animacao_%s_chaves) <= %d, \"%s: frames-chave demais\");"
+                     % (nome, MAX_CHAVES, fonte))
+        b.append("#if FIO_ATIVO")
+        b.append("extern const fio_tabela_t animacao_%s_fio;" % nome)
+        b.append("#endif")
+        b.append("uint32_t animacao_%s(uint32_t passo) {" % nome)
+        b.append("    return tocar_compacta(&animacao_%s_tabela, FIO_TABELA(animacao_%s_fio), passo);" % (nome, nome))
+        b.append("}")
+        blocos.append("\n".join(b))
+        nomes.append(nome)
+
+        f = ["// %s: %d frames" % (fonte, len(frames))]
+        f.append("constexpr fio::quadro animacao_%s_quadros[] = {" % nome)
+        f += ["    {0x%07x, RGB(%d, %d, %d)}, // frame %d" % ((m,) + c + (i,))
+              for i, (m, c, _, _) in enumerate(frames)]
+        f.append("};")
+        f.append("static_assert(fio::mascaras_validas(animacao_%s_quadros), \"%s: pixel fora do frame 5x5\");"
+                 % (nome, fonte))
+        f.append("constexpr auto animacao_%s_palavras =" % nome)
+        f.append("    fio::expandir<fio::distintos<%s>(animacao_%s_quadros), %s>(animacao_%s_quadros);"
+                 % (("true" if apagar else "false", nome) * 2))
+        f.append("extern \"C\" const fio_tabela_t animacao_%s_fio = {"
+                 "animacao_%s_palavras.p, animacao_%s_palavras.indice, count_of(animacao_%s_quadros)};"
+                 % ((nome,) * 4))
+        blocos_fio.append("\n".join(f))
+
+    texto = "\n".join([
+        "// Gerado por animacoes/compilar.py a partir de animacoes/*.anim. Não edite.",
+        "// Incluído só por animacoes.c, depois de tocar_compacta().",
+        "",
+        "#include \"compacta.h\"",
+        "#include \"fio.h\"",
+        "",
+        "\n\n".join(blocos),
+        "",
+    ])
+
+    texto_fio = "\n".join([
+        "// Gerado por animacoes/compilar.py a partir de animacoes/*.anim. Não edite.",
+        "// Incluído só por fio.cpp, que define fio::quadro e fio::expandir.",
+        "",
+        "\n\n".join(blocos_fio),
+        "",
+    ])
+
+    escrever(saida, texto)
+    escrever(saida_fio, texto_fio)
+
+
+# Sempre reescreve, para as saídas ficarem mais novas que as entradas: senão o
+# build considera o comando desatualizado e o roda de novo a cada vez
+def escrever(caminho, texto):
+    with open(caminho, "w", encoding="utf-8") as f:
+        f.write(texto)
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.stderr.write(__doc__)
+        return 2
+    try:
+        gerar(sys.argv[1], sys.argv[2], sys.argv[3:])
+    except ErroAnimacao as e:
+        sys.stderr.write("erro: %s\n" % e)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#include "camadas.h"
+#include "framebuffer.h"
+
+// Bytes 0 e 2 de uma palavra; os bytes 1 e 3 ficam nos mesmos lugares depois de >> 8.
+// Cada byte ganha 8 bits de folga, suficientes para o produto por um alfa de até 256.
+#define PARES 0x00FF00FFu
+// Bit mais alto de cada byte
+#define ALTOS 0x80808080u
+
+// 0xFF nos bytes com o bit mais alto ligado
+static inline uint32_t bytes_cheios(uint32_t altos) {
+    return (altos >> 7) * 0xFF;
+}
+
+static inline uint32_t escalar(uint32_t cor, uint32_t alfa) {
+    uint32_t pares = ((cor & PARES) * alfa >> 8) & PARES;
+    uint32_t impares = ((cor >> 8 & PARES) * alfa) & ~PARES;
+    return pares | impares;
+}
+
+// embaixo + (cima - embaixo) * alfa, com a parte de cima já multiplicada
+static inline uint32_t misturar_pre(uint32_t embaixo, uint32_t cima_pares, uint32_t cima_impares, uint32_t resto) {
+    uint32_t pares = ((cima_pares + (embaixo & PARES) * resto) >> 8) & PARES;
+    uint32_t impares = (cima_impares + (embaixo >> 8 & PARES) * resto) & ~PARES;
+    return pares | impares;
+}
+
+static inline uint32_t misturar(uint32_t embaixo, uint32_t cima, uint32_t alfa) {
+    return misturar_pre(embaixo, (cima & PARES) * alfa, (cima >> 8 & PARES) * alfa, CAMADA_OPACA - alfa);
+}
+
+static inline uint32_t somar(uint32_t a, uint32_t b) {
+    // Soma dos 7 bits de baixo, depois o bit alto sem propagar entre bytes
+    uint32_t soma = ((a & ~ALTOS) + (b & ~ALTOS)) ^ ((a ^ b) & ALTOS);
+    // Vai-um de cada byte: os dois bits altos ligados, ou um deles e o resultado desligado
+    uint32_t vai_um = ((a & b) | ((a | b) & ~soma)) & ALTOS;
+    return soma | bytes_cheios(vai_um);
+}
+
+static inline uint32_t maximo(uint32_t a, uint32_t b) {
+    // Bit alto de cada byte de t: os 7 bits de baixo de a >= os de b (nunca pede emprestado ao vizinho)
+    uint32_t t = (a | ALTOS) - (b & ~ALTOS);
+    uint32_t a_maior = ((a & ~b) | (~(a ^ b) & t)) & ALTOS;
+    uint32_t mascara = bytes_cheios(a_maior);
+    return (a & mascara) | (b & ~mascara);
+}
+
+uint32_t camadas_escalar(uint32_t cor, uint alfa) {
+    return escalar(cor, alfa);
+}
+
+uint32_t camadas_misturar(uint32_t embaixo, uint32_t cima, uint alfa) {
+    return misturar(embaixo, cima, alfa);
+}
+
+uint32_t camadas_somar(uint32_t a, uint32_t b) {
+    return somar(a, b);
+}
+
+uint32_t camadas_maximo(uint32_t a, uint32_t b) {
+    return maximo(a, b);
+}
+
+// Cor única sobre a tela inteira: a parte da camada é calculada uma vez
+static void compor_cor(uint32_t *saida, const camada_t *c) {
+    if (c->modo == CAMADA_ALFA) {
+        if (!c->cor) {
+            return; // Transparente
+        }
+        uint32_t pares = (c->cor & PARES) * c->alfa;
+        uint32_t impares = (c->cor >> 8 & PARES) * c->alfa;
+        uint32_t resto = CAMADA_OPACA - c->alfa;
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = misturar_pre(saida[i], pares, impares, resto);
+        }
+        return;
+    }
+    uint32_t cor = escalar(c->cor, c->alfa);
+    if (c->modo == CAMADA_SOMA) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = somar(saida[i], cor);
+        }
+    } else {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = maximo(saida[i], cor);
+        }
+    }
+}
+
+// Um laço por modo, para que o laço dos pixels não tenha escolha de modo
+static void compor_pixels(uint32_t *saida, const camada_t *c) {
+    const uint32_t *p = c->pixels;
+    uint32_t alfa = c->alfa;
+    switch (c->modo) {
+    case CAMADA_ALFA:
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            if (p[i]) {
+                saida[i] = misturar(saida[i], p[i], alfa);
+            }
+        }
+        break;
+    case CAMADA_SOMA:
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = somar(saida[i], escalar(p[i], alfa));
+        }
+        break;
+    case CAMADA_MAXIMO:
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = maximo(saida[i], escalar(p[i], alfa));
+        }
+        break;
+    }
+}
+
+// Uma camada sobre preto: qualquer modo dá a própria camada escalada
+static void copiar(uint32_t *saida, const camada_t *c) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        saida[i] = escalar(c->pixels ? c->pixels[i] : c->cor, c->alfa);
+    }
+}
+
+void camadas_compor(uint32_t *saida, const camada_t *camadas, uint n) {
+    if (n > CAMADAS_MAX) {
+        n = CAMADAS_MAX;
+    }
+    // Uma cor opaca cobre tudo o que está embaixo: a composição começa nela
+    uint base = 0;
+    for (uint k = 0; k < n; k++) {
+        const camada_t *c = &camadas[k];
+        if (!c->pixels && c->modo == CAMADA_ALFA && c->alfa == CAMADA_OPACA && c->cor) {
+            base = k;
+        }
+    }
+
+    bool vazia = true;
+    for (uint k = base; k < n; k++) {
+        const camada_t *c = &camadas[k];
+        if (!c->alfa) {
+            continue;
+        }
+        if (vazia) {
+            copiar(saida, c);
+            vazia = false;
+        } else if (c->pixels) {
+            compor_pixels(saida, c);
+        } else {
+            compor_cor(saida, c);
+        }
+    }
+    if (vazia) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            saida[i] = 0;
+        }
+    }
+}
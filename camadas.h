@@ -0,0 +1,40 @@
+#ifndef CAMADAS_H
+#define CAMADAS_H
+
+#include "hal.h"
+
+// Composição de camadas sobre a tela inteira (NUM_PIXELS palavras). As camadas
+// são empilhadas da primeira para a última, sobre preto. A mistura é feita byte
+// a byte dentro da palavra de 32 bits (SWAR), todos os canais de uma vez, então
+// serve tanto para palavras GRB do fio quanto para RGB de autoria.
+
+// Alfa em 0..CAMADA_OPACA
+#define CAMADA_OPACA 256
+
+// Máximo de camadas por composição
+#define CAMADAS_MAX 8
+
+typedef enum {
+    CAMADA_ALFA,   // Cobre o que está embaixo na proporção do alfa; pixel 0 é transparente
+    CAMADA_SOMA,   // Soma os canais, saturando em 255
+    CAMADA_MAXIMO, // Fica com o maior valor de cada canal
+} camada_modo_t;
+
+typedef struct {
+    const uint32_t *pixels; // Um por pixel na ordem do fio; NULL preenche tudo com 'cor'
+    uint32_t cor;
+    camada_modo_t modo;
+    uint16_t alfa;          // Aplicado a todos os modos (0 = camada ignorada)
+} camada_t;
+
+// Compõe até CAMADAS_MAX camadas em saida. O custo é uma passada pelos pixels
+// por camada, sem desvio por canal.
+void camadas_compor(uint32_t *saida, const camada_t *camadas, uint n);
+
+// Operações sobre uma palavra: cada um dos 4 bytes é um canal independente
+uint32_t camadas_escalar(uint32_t cor, uint alfa);
+uint32_t camadas_misturar(uint32_t embaixo, uint32_t cima, uint alfa);
+uint32_t camadas_somar(uint32_t a, uint32_t b);
+uint32_t camadas_maximo(uint32_t a, uint32_t b);
+
+#endif
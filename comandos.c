@@ -0,0 +1,70 @@
+#include "comandos.h"
+
+static comando_evento_t *evento_em(comandos_t *f, uint i) {
+    return &f->eventos[(f->inicio + i) % COMANDOS_MAX];
+}
+
+void comandos_init(comandos_t *f) {
+    f->inicio = 0;
+    f->qntd = 0;
+    f->estatisticas = (comandos_estatisticas_t){0};
+}
+
+// Tira da fila os comandos de tela pendentes, mantendo a ordem dos outros
+static void remover_tela(comandos_t *f) {
+    uint mantidos = 0;
+    for (uint i = 0; i < f->qntd; i++) {
+        comando_evento_t *e = evento_em(f, i);
+        if (e->tipo == COMANDO_TELA) {
+            f->estatisticas.combinados++;
+        } else {
+            *evento_em(f, mantidos++) = *e;
+        }
+    }
+    f->qntd = mantidos;
+}
+
+bool comandos_por(comandos_t *f, const comando_evento_t *evento) {
+    f->estatisticas.recebidos++;
+
+    if (evento->tipo == COMANDO_TELA) {
+        // O frame de um comando de tela ainda na fila seria trocado logo em seguida
+        remover_tela(f);
+    } else if (evento->tipo == COMANDO_ALTERNAR && f->qntd &&
+               evento_em(f, f->qntd - 1)->comando == evento->comando) {
+        // Ligar e desligar o mesmo modo em seguida não muda nada
+        f->qntd--;
+        f->estatisticas.combinados += 2;
+        return true;
+    }
+
+    if (f->qntd == COMANDOS_MAX) {
+        f->estatisticas.descartados++;
+        return false;
+    }
+    *evento_em(f, f->qntd++) = *evento;
+    if (f->qntd > f->estatisticas.profundidade_max) {
+        f->estatisticas.profundidade_max = f->qntd;
+    }
+    return true;
+}
+
+bool comandos_tirar(comandos_t *f, comando_evento_t *evento, hal_tempo_t agora) {
+    if (!f->qntd) {
+        return false;
+    }
+    *evento = *evento_em(f, 0);
+    f->inicio = (f->inicio + 1) % COMANDOS_MAX;
+    f->qntd--;
+
+    f->estatisticas.executados++;
+    uint64_t espera = agora > evento->instante ? agora - evento->instante : 0;
+    if (espera > f->estatisticas.espera_max_us) {
+        f->estatisticas.espera_max_us = espera > UINT32_MAX ? UINT32_MAX : espera;
+    }
+    return true;
+}
+
+bool comandos_vazia(const comandos_t *f) {
+    return f->qntd == 0;
+}
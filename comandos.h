@@ -0,0 +1,53 @@
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+#include "hal.h"
+#include "animacao.h"
+
+// Fila de comandos do teclado no núcleo 1. Os comandos que chegam juntos (uma
+// rajada de teclas enquanto um frame sai) são combinados ao entrar na fila,
+// para que nenhum frame seja desenhado só para ser substituído em seguida.
+#define COMANDOS_MAX 8
+
+// Como um comando se combina com os que ainda esperam na fila
+typedef enum {
+    COMANDO_TELA,      // Desenha a tela inteira: substitui os comandos de tela pendentes
+    COMANDO_ALTERNAR,  // Liga/desliga um modo: dois seguidos se anulam
+    COMANDO_ACUMULAR,  // Muda um estado a cada vez: nunca é combinado
+} comando_tipo_t;
+
+typedef struct {
+    animacao_passo_t comando;
+    comando_tipo_t tipo;
+    hal_tempo_t instante; // Quando a tecla foi entregue pelo teclado
+} comando_evento_t;
+
+// Contadores desde o início
+typedef struct {
+    uint32_t recebidos;
+    uint32_t executados;
+    uint32_t combinados;  // Retirados da fila por um comando posterior
+    uint32_t descartados; // Fila cheia
+    uint32_t profundidade_max;
+    uint32_t espera_max_us; // Maior tempo entre a tecla e o início do comando
+} comandos_estatisticas_t;
+
+typedef struct {
+    comando_evento_t eventos[COMANDOS_MAX];
+    uint inicio;
+    uint qntd;
+    comandos_estatisticas_t estatisticas;
+} comandos_t;
+
+void comandos_init(comandos_t *f);
+
+// Coloca o comando na fila aplicando as regras de combinação. Retorna false
+// se ele foi descartado (fila cheia).
+bool comandos_por(comandos_t *f, const comando_evento_t *evento);
+
+// Retira o próximo comando a executar, registrando a espera; false se não há
+bool comandos_tirar(comandos_t *f, comando_evento_t *evento, hal_tempo_t agora);
+
+bool comandos_vazia(const comandos_t *f);
+
+#endif
@@ -0,0 +1,67 @@
+#include "compacta.h"
+#include "cor.h"
+
+#define ARG(cab) ((cab) & 0x1F)
+
+void compacta_iniciar(compacta_leitor_t *leitor, const compacta_t *animacao) {
+    leitor->animacao = animacao;
+    leitor->pos = 0;
+    leitor->frame = 0;
+    leitor->volta = 0;
+    leitor->fim = false;
+    leitor->atual = 0;
+    leitor->cor = 0;
+    leitor->ms = 0;
+}
+
+bool compacta_proximo(compacta_leitor_t *leitor) {
+    const compacta_t *a = leitor->animacao;
+    if (leitor->fim) {
+        return false;
+    }
+    if (leitor->frame >= a->num_frames || leitor->pos >= a->tamanho) {
+        if (++leitor->volta < a->repeticoes) {
+            leitor->pos = 0;
+            leitor->frame = 0;
+        } else {
+            leitor->fim = true;
+            if (!a->apagar_no_fim) {
+                return false;
+            }
+            leitor->atual = 0; // Frame apagado e sem duração: a animação acaba nele
+            leitor->ms = 0;
+            return true;
+        }
+    }
+
+    uint8_t cab = a->dados[leitor->pos++];
+    uint n = (cab & C_CHAVE(0)) ? 0 : ARG(cab);
+    uint tamanho = n + ((cab & C_COM_MS) ? 2 : 0) + ((cab & C_COM_COR) ? 3 : 0);
+    if (leitor->pos + tamanho > a->tamanho) {
+        leitor->fim = true;
+        return false;
+    }
+
+    const uint8_t *p = &a->dados[leitor->pos];
+    leitor->pos += tamanho;
+    if (cab & C_COM_MS) {
+        leitor->ms = p[0] | p[1] << 8;
+        p += 2;
+    }
+    if (cab & C_COM_COR) {
+        leitor->cor = RGB(p[0], p[1], p[2]);
+        p += 3;
+    }
+
+    if (cab & C_CHAVE(0)) {
+        leitor->atual = a->chaves[ARG(cab)];
+    } else {
+        // Cada índice inverte um pixel: acende o que estava apagado e vice-versa
+        for (uint i = 0; i < n; i++) {
+            leitor->atual ^= (frame_t)1 << p[i];
+        }
+    }
+
+    leitor->frame++;
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef COMPACTA_H
+#define COMPACTA_H
+
+#include "hal.h"
+#include "frames.h"
+
+// Animação compactada: um fluxo de bytes com um registro por frame. Cada
+// registro começa com um cabeçalho:
+//   bit 7     C_COM_COR: seguem 3 bytes com a nova cor RGB (senão vale a anterior)
+//   bit 6     tipo: C_DELTA inverte os n pixels listados no fim do registro (n nos
+//             bits 4-0; n = 0 repete o frame anterior), C_CHAVE copia chaves[i] (i nos bits 4-0)
+//   bit 5     C_COM_MS: seguem 2 bytes com a nova duração em ms (senão vale a anterior)
+// A ordem no registro é: cabeçalho, duração, cor, índices dos pixels.
+// Frames repetidos ficam uma vez só em chaves[] e são referenciados pelo índice.
+// As tabelas são geradas a partir de animacoes/*.anim por animacoes/compilar.py.
+
+#define C_DELTA(n) (0x00 | (n))
+#define C_CHAVE(i) (0x40 | (i))
+#define C_COM_MS 0x20
+#define C_COM_COR 0x80
+#define C_MS(ms) ((ms) & 0xFF), ((ms) >> 8)
+#define C_COR(r, g, b) (r), (g), (b)
+
+typedef struct {
+    const frame_t *chaves;
+    const uint8_t *dados;
+    uint16_t tamanho;    // Bytes em dados
+    uint16_t num_frames; // Frames por volta
+    uint8_t repeticoes;  // Voltas completas (o primeiro registro precisa ser uma chave se > 1)
+    bool apagar_no_fim;  // Entrega um frame apagado, com ms = 0, depois da última volta
+} compacta_t;
+
+// Decodificador em fluxo: reconstrói cada frame sobre o anterior, sem heap
+typedef struct {
+    const compacta_t *animacao;
+    uint16_t pos;
+    uint16_t frame;  // Frames já decodificados na volta atual
+    uint8_t volta;
+    bool fim;
+    frame_t atual;
+    uint32_t cor;    // Cor RGB do frame atual
+    uint16_t ms;     // Duração do frame atual
+} compacta_leitor_t;
+
+void compacta_iniciar(compacta_leitor_t *leitor, const compacta_t *animacao);
+
+// Decodifica o próximo frame em leitor->atual, com cor e duração.
+// Retorna false quando a animação acabou (ou os dados estão truncados).
+bool compacta_proximo(compacta_leitor_t *leitor);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef COR_H
+#define COR_H
+
+#include <stdint.h>
+
+// Cor RGB de 8 bits por canal (valores de autoria, antes da correção de gama)
+#define RGB(r, g, b) (((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b))
+#define RGB_R(c) ((uint8_t)((c) >> 16))
+#define RGB_G(c) ((uint8_t)((c) >> 8))
+#define RGB_B(c) ((uint8_t)(c))
+
+// Canal em ponto fixo Q8.8: Q8(1.0) = 256
+#define Q8(x) ((uint16_t)((x) * 256))
+
+// Brilho global aplicado depois da gama (255 = 100%)
+void cor_definir_brilho(uint8_t brilho);
+uint8_t cor_brilho(void);
+
+// Converte uma cor RGB na palavra GRB esperada pelo pio_matrix, passando pela tabela de gama e brilho
+uint32_t cor_grb(uint32_t rgb);
+
+// Um canal depois da gama e do brilho, com 16 bits (65535 = 100%)
+uint16_t cor_linear(uint8_t valor);
+
+uint32_t cor_rgb(uint8_t r, uint8_t g, uint8_t b);
+
+// Mesmo que cor_rgb, com canais em Q8.8; valores acima de 1.0 saturam
+uint32_t cor_rgb_q8(uint16_t r, uint16_t g, uint16_t b);
+
+// Interpolação inteira de 'de' até 'para' no passo indicado (0 = de, total = para)
+uint32_t cor_interpolar(uint32_t de, uint32_t para, uint32_t passo, uint32_t total);
+
+#endif
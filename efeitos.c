@@ -0,0 +1,135 @@
+#include "efeitos.h"
+#include "tela.h"
+
+static void apagar(uint32_t *pixels) {
+    for (int i = 0; i < TELA_PIXELS; i++) {
+        pixels[i] = 0;
+    }
+}
+
+// Anéis: as distâncias usam coordenadas dobradas a partir do centro da tela,
+// para o centro cair entre pixels quando a dimensão é par
+
+// Menor raio que alcança os cantos
+static uint32_t raio_maximo(void) {
+    uint32_t canto = (TELA_LARGURA - 1) * (TELA_LARGURA - 1) + (TELA_ALTURA - 1) * (TELA_ALTURA - 1);
+    uint32_t r = 0;
+    while (4 * r * r < canto) {
+        r++;
+    }
+    return r;
+}
+
+static uint32_t aneis_passos(const efeito_t *e) {
+    // O disco acaba quando cobre a tela; o anel, quando a borda interna passa dos cantos
+    return raio_maximo() + (e->comprimento ? e->comprimento : 1);
+}
+
+static void aneis_desenhar(const efeito_t *e, uint32_t *pixels, uint32_t passo, uint32_t cor) {
+    int32_t externo = 4 * passo * passo;
+    int32_t r_interno = (int32_t)passo - e->comprimento;
+    int32_t interno = e->comprimento && r_interno >= 0 ? 4 * r_interno * r_interno : -1;
+    // Linha a linha, um trecho contíguo no fio por painel
+    for (uint y = 0; y < TELA_ALTURA; y++) {
+        int32_t dy = 2 * (int32_t)y - (TELA_ALTURA - 1);
+        for (uint x0 = 0; x0 < TELA_LARGURA; x0 += TELA_PAINEL_LARGURA) {
+            int passo_x;
+            uint32_t *p = &pixels[tela_trecho(&tela, x0, y, &passo_x)];
+            for (int32_t x = x0; x < (int32_t)(x0 + TELA_PAINEL_LARGURA); x++, p += passo_x) {
+                int32_t dx = 2 * x - (TELA_LARGURA - 1);
+                int32_t d = dx * dx + dy * dy;
+                *p = d <= externo && d > interno ? cor : 0;
+            }
+        }
+    }
+}
+
+const efeito_tipo_t efeito_aneis = {aneis_passos, aneis_desenhar};
+
+// Cobra: a cabeça está no ponto 'passo' do caminho (entrando e saindo) ou, em
+// voltas, no ponto 'passo + comprimento - 1', para começar com o corpo inteiro
+
+static uint32_t cobra_passos(const efeito_t *e) {
+    uint x, y;
+    uint total = e->caminho(TELA_LARGURA, TELA_ALTURA, 0, &x, &y);
+    return e->voltas ? e->voltas * total : total + e->comprimento;
+}
+
+static void cobra_desenhar(const efeito_t *e, uint32_t *pixels, uint32_t passo, uint32_t cor) {
+    uint x, y;
+    uint total = e->caminho(TELA_LARGURA, TELA_ALTURA, 0, &x, &y);
+    apagar(pixels);
+    uint32_t cabeca = e->voltas ? passo + e->comprimento - 1 : passo;
+    for (uint k = 0; k < e->comprimento && k <= cabeca; k++) {
+        uint32_t i = cabeca - k;
+        if (e->voltas) {
+            i %= total;
+        } else if (i >= total) {
+            continue;
+        }
+        e->caminho(TELA_LARGURA, TELA_ALTURA, i, &x, &y);
+        pixels[tela_indice(&tela, x, y)] = cor;
+    }
+}
+
+const efeito_tipo_t efeito_cobra = {cobra_passos, cobra_desenhar};
+
+// Barra: no passo p, as p + 1 linhas de baixo estão acesas
+
+static uint32_t barra_passos(const efeito_t *e) {
+    (void)e;
+    return TELA_ALTURA;
+}
+
+static void barra_desenhar(const efeito_t *e, uint32_t *pixels, uint32_t passo, uint32_t cor) {
+    (void)e;
+    for (uint y = 0; y < TELA_ALTURA; y++) {
+        uint32_t valor = TELA_ALTURA - y <= passo + 1 ? cor : 0;
+        for (uint x0 = 0; x0 < TELA_LARGURA; x0 += TELA_PAINEL_LARGURA) {
+            int passo_x;
+            uint32_t *p = &pixels[tela_trecho(&tela, x0, y, &passo_x)];
+            for (uint x = 0; x < TELA_PAINEL_LARGURA; x++, p += passo_x) {
+                *p = valor;
+            }
+        }
+    }
+}
+
+const efeito_tipo_t efeito_barra = {barra_passos, barra_desenhar};
+
+// Caminhos
+
+uint efeito_caminho_zigue_zague(uint largura, uint altura, uint i, uint *x, uint *y) {
+    // Linhas cheias em altura - 1, altura - 3, ..., ligadas por um ponto na ponta
+    uint linhas = (altura + 1) / 2;
+    uint trecho = i / (largura + 1);
+    uint j = i % (largura + 1);
+    *y = altura - 1 - 2 * trecho;
+    if (j == largura) {
+        // Ligação para a próxima linha cheia, na ponta onde esta terminou
+        *x = trecho % 2 ? largura - 1 : 0;
+        *y -= 1;
+    } else {
+        *x = trecho % 2 ? j : largura - 1 - j;
+    }
+    return linhas * largura + linhas - 1;
+}
+
+uint efeito_caminho_borda(uint largura, uint altura, uint i, uint *x, uint *y) {
+    uint base = largura - 1;
+    uint lado = altura - 1;
+    if (i < base) {
+        *x = largura - 1 - i; // Embaixo, para a esquerda
+        *y = altura - 1;
+    } else if (i < base + lado) {
+        *x = 0; // À esquerda, para cima
+        *y = altura - 1 - (i - base);
+    } else if (i < 2 * base + lado) {
+        *x = i - base - lado; // Em cima, para a direita
+        *y = 0;
+    } else {
+        *x = largura - 1; // À direita, para baixo
+        *y = i - 2 * base - lado;
+    }
+    return 2 * (base + lado);
+}
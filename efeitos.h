@@ -0,0 +1,46 @@
+#ifndef EFEITOS_H
+#define EFEITOS_H
+
+#include "hal.h"
+
+// Efeitos procedurais: em vez de uma tabela de frames, cada passo é calculado
+// pixel a pixel em aritmética inteira, sobre a tela inteira (TELA_LARGURA x
+// TELA_ALTURA), seja qual for a resolução.
+
+typedef struct efeito efeito_t;
+
+typedef struct {
+    // Número de passos do efeito com estes parâmetros e a tela atual
+    uint32_t (*passos)(const efeito_t *e);
+    // Desenha o passo indicado em todos os pixels (palavras GRB, ordem do fio)
+    void (*desenhar)(const efeito_t *e, uint32_t *pixels, uint32_t passo, uint32_t cor);
+} efeito_tipo_t;
+
+// Caminho sobre uma tela largura x altura: coloca em (x, y) o ponto i (i menor
+// que o comprimento) e retorna o comprimento do caminho
+typedef uint (*efeito_caminho_t)(uint largura, uint altura, uint i, uint *x, uint *y);
+
+struct efeito {
+    const efeito_tipo_t *tipo;
+    uint32_t cor;              // RGB no primeiro passo
+    uint32_t cor_final;        // RGB para onde a cor caminha ao longo do efeito
+    uint16_t ms;               // Velocidade: duração de cada passo
+    uint8_t comprimento;       // Cobra: pixels do corpo. Anéis: espessura (0 = disco cheio)
+    uint8_t voltas;            // Cobra: 0 entra e sai do caminho; n dá n voltas com o corpo inteiro
+    efeito_caminho_t caminho;  // Cobra
+    bool apagar_no_fim;
+};
+
+// Anéis saindo do centro, um pixel de raio por passo, até deixarem a tela
+extern const efeito_tipo_t efeito_aneis;
+// Cobra andando por um caminho, com a cabeça um ponto à frente a cada passo
+extern const efeito_tipo_t efeito_cobra;
+// Barra enchendo de baixo para cima, uma linha por passo
+extern const efeito_tipo_t efeito_barra;
+
+// Linhas alternadas a partir do canto inferior direito, em zigue-zague
+uint efeito_caminho_zigue_zague(uint largura, uint altura, uint i, uint *x, uint *y);
+// Borda da tela no sentido horário, a partir do canto inferior direito
+uint efeito_caminho_borda(uint largura, uint altura, uint i, uint *x, uint *y);
+
+#endif
@@ -0,0 +1,104 @@
+// Expansão dos frames das animações .anim nas palavras do fio, em tempo de
+// compilação (constexpr do C++17). Os frames, com máscara e cor, vêm de
+// animacoes_fio.h, gerado por animacoes/compilar.py junto com animacoes_geradas.h.
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "fio.h"
+#include "cor.h"
+#include "cor_gama.h"
+}
+
+#if FIO_ATIVO
+
+namespace fio {
+
+constexpr uint8_t gama[256] = {COR_GAMA_VALORES};
+
+// O mesmo que cor_grb com o brilho em 100%
+constexpr uint32_t grb(uint32_t rgb) {
+    return (uint32_t)gama[RGB_G(rgb)] << 24 | (uint32_t)gama[RGB_R(rgb)] << 16 | (uint32_t)gama[RGB_B(rgb)] << 8;
+}
+
+struct quadro {
+    frame_t mascara;
+    uint32_t cor; // RGB de autoria
+};
+
+// Frames distintos em p, e o índice em p de cada frame da animação
+template <size_t M, size_t N>
+struct palavras {
+    uint32_t p[M][FRAME_PIXELS];
+    uint8_t indice[N];
+};
+
+template <size_t N>
+constexpr bool mascaras_validas(const quadro (&quadros)[N]) {
+    for (size_t f = 0; f < N; f++) {
+        if (quadros[f].mascara >> FRAME_PIXELS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Frame f da animação; depois do último, o apagado do fim
+template <size_t N>
+constexpr quadro quadro_em(const quadro (&quadros)[N], size_t f) {
+    return f < N ? quadros[f] : quadro{0, 0};
+}
+
+// Mesmas palavras no fio (apagados são iguais em qualquer cor)
+constexpr bool iguais(quadro a, quadro b) {
+    return a.mascara == b.mascara && (a.mascara == 0 || grb(a.cor) == grb(b.cor));
+}
+
+// Primeiro frame igual ao frame f, ou o próprio f
+template <size_t N>
+constexpr size_t primeiro_igual(const quadro (&quadros)[N], size_t f) {
+    size_t g = 0;
+    while (!iguais(quadro_em(quadros, g), quadro_em(quadros, f))) {
+        g++;
+    }
+    return g;
+}
+
+template <bool APAGAR, size_t N>
+constexpr size_t distintos(const quadro (&quadros)[N]) {
+    size_t m = 0;
+    for (size_t f = 0; f < N + APAGAR; f++) {
+        m += primeiro_igual(quadros, f) == f;
+    }
+    return m;
+}
+
+// Expande os frames na ordem do frame_t (a do fio no painel 5x5), uma vez
+// cada frame distinto: frames repetidos apontam para as mesmas palavras, e o
+// framebuffer não reenvia o mesmo frame duas vezes seguidas
+template <size_t M, bool APAGAR, size_t N>
+constexpr palavras<M, N + APAGAR> expandir(const quadro (&quadros)[N]) {
+    palavras<M, N + APAGAR> r{};
+    size_t m = 0;
+    for (size_t f = 0; f < N + APAGAR; f++) {
+        size_t g = primeiro_igual(quadros, f);
+        if (g < f) {
+            r.indice[f] = r.indice[g];
+            continue;
+        }
+        quadro q = quadro_em(quadros, f);
+        uint32_t cor = grb(q.cor);
+        for (size_t i = 0; i < FRAME_PIXELS; i++) {
+            r.p[m][i] = (q.mascara >> i & 1) ? cor : 0;
+        }
+        r.indice[f] = m++;
+    }
+    return r;
+}
+
+} // namespace fio
+
+#include "animacoes_fio.h"
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef FIO_H
+#define FIO_H
+
+#include "hal.h"
+#include "frames.h"
+#include "tela.h"
+
+// Frames das animações de animacoes/*.anim já expandidos no build, por fio.cpp,
+// nas palavras GRB que o pio_matrix envia (gama aplicada, brilho de 100%). As
+// tabelas são const e ficam na flash, de onde o DMA lê direto. Só existem na
+// tela de um único painel 5x5, em que cada frame é a tela inteira.
+#define FIO_ATIVO (TELA_PIXELS == FRAME_PIXELS)
+
+// Limite de frames por animação (o índice é de 8 bits), conferido por animacoes/compilar.py
+#define FIO_MAX_FRAMES 255
+
+// Frame i da animação: palavras[indice[i]]. Frames repetidos são guardados uma
+// vez só. Depois dos num_frames frames vem o apagado do fim, se a animação apaga.
+typedef struct {
+    const uint32_t (*palavras)[FRAME_PIXELS];
+    const uint8_t *indice;
+    uint16_t num_frames;
+} fio_tabela_t;
+
+// Tabela da animação, ou NULL quando a tela não permite usá-las
+#if FIO_ATIVO
+#define FIO_TABELA(t) (&(t))
+#else
+#define FIO_TABELA(t) NULL
+#endif
+
+#endif
@@ -0,0 +1,152 @@
+#include <string.h>
+#include "fluxo.h"
+
+// Anel de frames com um produtor (recebimento) e um consumidor (reprodução),
+// sem trava: cada lado só escreve o próprio contador. Os frames publicados e
+// ainda não consumidos formam a fila; o anterior ao primeiro da fila está nos
+// LEDs (ou no DMA) e o seguinte ao último recebe os próximos bytes.
+static fluxo_quadro_t quadros[FLUXO_QUADROS];
+static volatile uint32_t publicados = 0;
+static volatile uint32_t consumidos = 0;
+
+// Recebimento
+static uint8_t cabecalho[FLUXO_CABECALHO];
+static bool na_carga = false;
+static size_t pos = 0;
+static bool sincronizado = true;
+static bool recebeu = false;
+static uint16_t seq_esperada;
+static uint32_t recebidos, cheios, perdidos, corrompidos;
+
+// Reprodução
+static bool tocando = false;
+static uint32_t exibidos, velhos, atrasados;
+
+static uint16_t ler16(const uint8_t *p) {
+    return p[0] | (uint16_t)p[1] << 8;
+}
+
+uint16_t fluxo_soma(const uint8_t *dados, size_t n) {
+    uint32_t a = 0, b = 0;
+    for (size_t i = 0; i < n; i++) {
+        a = (a + dados[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return b << 8 | a;
+}
+
+uint8_t *fluxo_destino(size_t *quanto) {
+    if (na_carga) {
+        *quanto = FLUXO_TAMANHO - pos;
+        return (uint8_t *)quadros[publicados % FLUXO_QUADROS].pixels + pos;
+    }
+    *quanto = FLUXO_CABECALHO - pos;
+    return cabecalho + pos;
+}
+
+// Cabeçalho inválido: procura a marca de novo a partir do segundo byte
+static void ressincronizar(void) {
+    if (sincronizado) {
+        corrompidos++;
+        sincronizado = false;
+    }
+    size_t i = 1;
+    while (i < FLUXO_CABECALHO && cabecalho[i] != FLUXO_MARCA0) {
+        i++;
+    }
+    memmove(cabecalho, cabecalho + i, FLUXO_CABECALHO - i);
+    pos = FLUXO_CABECALHO - i;
+}
+
+static bool cabecalho_valido(void) {
+    return cabecalho[0] == FLUXO_MARCA0 && cabecalho[1] == FLUXO_MARCA1 && ler16(cabecalho + 4) != 0 &&
+           ler16(cabecalho + 6) == FLUXO_TAMANHO;
+}
+
+bool fluxo_recebido(size_t n) {
+    pos += n;
+    if (!na_carga) {
+        if (pos < FLUXO_CABECALHO) {
+            return false;
+        }
+        if (!cabecalho_valido()) {
+            ressincronizar();
+            return false;
+        }
+        sincronizado = true;
+        na_carga = true;
+        pos = 0;
+        return false;
+    }
+    if (pos < FLUXO_TAMANHO) {
+        return false;
+    }
+    na_carga = false;
+    pos = 0;
+
+    fluxo_quadro_t *q = &quadros[publicados % FLUXO_QUADROS];
+    if (fluxo_soma((const uint8_t *)q->pixels, FLUXO_TAMANHO) != ler16(cabecalho + 8)) {
+        corrompidos++;
+        return false;
+    }
+    q->seq = ler16(cabecalho + 2);
+    q->ms = ler16(cabecalho + 4);
+    // Sequência que volta atrás é um transmissor que recomeçou, não perda
+    int16_t lacuna = q->seq - seq_esperada;
+    if (recebeu && lacuna > 0) {
+        perdidos += lacuna;
+    }
+    recebeu = true;
+    seq_esperada = q->seq + 1;
+    recebidos++;
+
+    // O próximo a receber não pode ser o frame nos LEDs: com a fila cheia o
+    // frame novo é descartado e o mesmo lugar recebe o seguinte
+    if (publicados - consumidos >= FLUXO_QUADROS - 2) {
+        cheios++;
+        return false;
+    }
+    __sync_synchronize(); // O frame fica visível antes do contador
+    publicados++;
+    return true;
+}
+
+const fluxo_quadro_t *fluxo_proximo(void) {
+    uint32_t fila = publicados - consumidos;
+    if (!tocando) {
+        if (fila < FLUXO_PREENCHER) {
+            return NULL;
+        }
+        tocando = true;
+    } else if (fila == 0) {
+        // Chegou a hora do próximo frame e ele não está aqui: o atual continua
+        // nos LEDs e a fila volta a encher
+        atrasados++;
+        tocando = false;
+        return NULL;
+    }
+    __sync_synchronize();
+    return &quadros[consumidos % FLUXO_QUADROS];
+}
+
+void fluxo_avancar(void) {
+    exibidos++;
+    __sync_synchronize(); // Terminou de ler o frame antes de liberá-lo
+    consumidos++;
+}
+
+void fluxo_reiniciar(void) {
+    uint32_t p = publicados;
+    velhos += p - consumidos;
+    consumidos = p;
+    tocando = false;
+}
+
+void fluxo_estatisticas(fluxo_estatisticas_t *e) {
+    e->recebidos = recebidos;
+    e->exibidos = exibidos;
+    e->descartados = cheios + velhos;
+    e->atrasados = atrasados;
+    e->perdidos = perdidos;
+    e->corrompidos = corrompidos;
+}
@@ -0,0 +1,72 @@
+#ifndef FLUXO_H
+#define FLUXO_H
+
+#include "hal.h"
+#include "framebuffer.h"
+
+// Fluxo de frames ao vivo pela USB (CDC), só no build com -DFLUXO=ON. Cada
+// pacote tem um cabeçalho de 10 bytes, todos os campos em little-endian:
+//
+//   'F' 'X'  marca de início
+//   seq      número de sequência (16 bits, continua depois de 65535 em 0)
+//   ms       tempo de exibição do frame
+//   tamanho  bytes da carga: NUM_PIXELS palavras de 32 bits
+//   soma     Fletcher-16 da carga
+//
+// seguido da carga, no formato do buffer do framebuffer (GRB nos 24 bits altos
+// de cada palavra, na ordem do fio). A carga é recebida direto num anel de
+// frames e enviada dali pelo DMA, sem cópias intermediárias.
+#ifndef FLUXO
+#define FLUXO 0
+#endif
+
+#define FLUXO_MARCA0 'F'
+#define FLUXO_MARCA1 'X'
+#define FLUXO_CABECALHO 10
+#define FLUXO_TAMANHO (NUM_PIXELS * 4)
+
+// Frames no anel: um recebendo, um nos LEDs e até FLUXO_QUADROS - 2 na fila
+#define FLUXO_QUADROS 6
+// Frames na fila antes de a reprodução começar (ou recomeçar, depois de a fila
+// esvaziar): absorvem a variação no tempo de chegada
+#define FLUXO_PREENCHER 2
+// Intervalo de consulta da fila enquanto ela enche
+#define FLUXO_ESPERA_MS 1
+
+typedef struct {
+    uint32_t pixels[NUM_PIXELS];
+    uint16_t seq;
+    uint16_t ms;
+} fluxo_quadro_t;
+
+// Contadores desde o início
+typedef struct {
+    uint32_t recebidos;   // Pacotes completos e válidos
+    uint32_t exibidos;    // Frames enviados aos LEDs
+    uint32_t descartados; // Frames jogados fora: fila cheia ou velhos ao entrar no modo
+    uint32_t atrasados;   // Prazos em que o próximo frame ainda não tinha chegado
+    uint32_t perdidos;    // Lacunas na sequência (pacotes que não chegaram ou vieram corrompidos)
+    uint32_t corrompidos; // Cabeçalhos inválidos e cargas com soma errada
+} fluxo_estatisticas_t;
+
+// Lado do recebimento (núcleo 0). O transporte lê direto para o destino até
+// 'quanto' bytes e informa quantos chegaram. Retorna true quando um frame entra
+// na fila.
+uint8_t *fluxo_destino(size_t *quanto);
+bool fluxo_recebido(size_t n);
+
+// Lado da reprodução (núcleo 1). fluxo_proximo retorna o frame a exibir agora,
+// ou NULL enquanto a fila enche; depois de ele ir para o framebuffer,
+// fluxo_avancar libera o frame anterior para o recebimento.
+const fluxo_quadro_t *fluxo_proximo(void);
+void fluxo_avancar(void);
+
+// Descarta a fila e volta a enchê-la antes de reproduzir
+void fluxo_reiniciar(void);
+
+void fluxo_estatisticas(fluxo_estatisticas_t *estatisticas);
+
+// Fletcher-16, o mesmo do transmissor
+uint16_t fluxo_soma(const uint8_t *dados, size_t n);
+
+#endif
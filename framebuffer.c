@@ -0,0 +1,142 @@
+#include "framebuffer.h"
+#include "paralelo.h"
+#include "telemetria.h"
+#include "latencia.h"
+#include "gravador.h"
+
+// Profundidade da FIFO TX unida (8 palavras) mais o registrador OSR
+#define FIFO_PROFUNDIDADE 9
+
+// Dois buffers: um é lido pelo DMA enquanto o outro recebe o próximo frame
+static uint32_t buffers[2][NUM_PIXELS];
+static uint desenho = 0;
+
+#if TELA_FAIXAS > 1
+// Com várias faixas o DMA lê os planos de bits, transpostos a cada envio
+#define PALAVRAS (PARALELO_PALAVRAS_POR_PIXEL * TELA_PIXELS_POR_FAIXA)
+#define US_POR_PALAVRA (FRAMEBUFFER_US_POR_PIXEL / PARALELO_PALAVRAS_POR_PIXEL)
+static uint32_t planos[PALAVRAS];
+#else
+#define PALAVRAS NUM_PIXELS
+#define US_POR_PALAVRA FRAMEBUFFER_US_POR_PIXEL
+#endif
+
+// O último frame transmitido fica no outro buffer; só vale depois do primeiro envio
+static bool enviado_valido = false;
+// Buffer externo transmitido por último, se o último envio foi de um
+static const uint32_t *externo_enviado = NULL;
+// O que está nos LEDs: buffer de desenho anterior ou buffer externo
+static const uint32_t *ultimo_enviado = NULL;
+static framebuffer_estatisticas_t estatisticas;
+
+static volatile bool ocupado = false;
+static volatile uint64_t fim_latch_us = 0;
+static framebuffer_callback_t fim_callback = NULL;
+
+// Fim da transferência (no RP2040, no IRQ do DMA): o DMA já entregou tudo,
+// mas a FIFO ainda está esvaziando
+static void fim_dma(hal_tempo_t agora) {
+    uint pendentes = PALAVRAS < FIFO_PROFUNDIDADE ? PALAVRAS : FIFO_PROFUNDIDADE;
+    uint64_t fim = agora + pendentes * US_POR_PALAVRA + FRAMEBUFFER_LATCH_US;
+    fim_latch_us = fim;
+    ocupado = false;
+    telemetria_dma_fim(agora);
+    latencia_travado(fim);
+
+    if (fim_callback) {
+        fim_callback(fim);
+    }
+}
+
+uint32_t *framebuffer_desenho(void) {
+    return buffers[desenho];
+}
+
+// Compara o frame desenhado com o último transmitido (sai na primeira diferença)
+static bool framebuffer_igual_ao_enviado(void) {
+    if (!enviado_valido) {
+        return false;
+    }
+    const uint32_t *novo = buffers[desenho];
+    const uint32_t *enviado = buffers[desenho ^ 1];
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (novo[i] != enviado[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nada muda nos LEDs: o frame anterior só fica mais tempo na tela
+static void pular(void) {
+    estatisticas.pulados++;
+    estatisticas.us_economizados += FRAMEBUFFER_US_POR_FRAME;
+    latencia_frame(false, hal_agora());
+}
+
+// Espera o frame anterior sair e dispara o DMA a partir de pixels
+static void enviar(const uint32_t *pixels) {
+    framebuffer_aguardar();
+    latencia_frame(true, hal_agora());
+
+    estatisticas.enviados++;
+    ultimo_enviado = pixels;
+    ocupado = true;
+    telemetria_dma_inicio(hal_agora());
+#if TELA_FAIXAS > 1
+    // Os planos só são reescritos depois que o DMA terminou de lê-los
+    paralelo_transpor(pixels, TELA_FAIXAS, TELA_PIXELS_POR_FAIXA, planos);
+    hal_saida_enviar(planos, PALAVRAS, fim_dma);
+#else
+    hal_saida_enviar(pixels, PALAVRAS, fim_dma);
+#endif
+    // Enquanto o DMA lê o frame, que também não muda durante a gravação
+    gravador_frame(pixels, hal_agora());
+}
+
+void framebuffer_mostrar(void) {
+    if (framebuffer_igual_ao_enviado()) {
+        pular();
+        return;
+    }
+
+    enviar(buffers[desenho]);
+    enviado_valido = true;
+    externo_enviado = NULL;
+    desenho ^= 1;
+}
+
+void framebuffer_mostrar_buffer(const uint32_t *pixels) {
+    if (pixels == externo_enviado) {
+        pular();
+        return;
+    }
+
+    enviar(pixels);
+    externo_enviado = pixels;
+    // O outro buffer de desenho deixa de ser o que está nos LEDs
+    enviado_valido = false;
+}
+
+const uint32_t *framebuffer_enviado(void) {
+    return ultimo_enviado;
+}
+
+bool framebuffer_ocupado(void) {
+    return ocupado;
+}
+
+void framebuffer_aguardar(void) {
+    while (ocupado) {
+        tight_loop_contents();
+    }
+    hal_esperar_ate(fim_latch_us);
+}
+
+void framebuffer_set_callback(framebuffer_callback_t callback) {
+    fim_callback = callback;
+}
+
+void framebuffer_estatisticas(framebuffer_estatisticas_t *saida) {
+    *saida = estatisticas;
+}
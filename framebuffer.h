@@ -0,0 +1,69 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "hal.h"
+#include "tela.h"
+
+// Pixels na corrente inteira, em todos os painéis
+#define NUM_PIXELS TELA_PIXELS
+
+// Tempo de cada pixel no fio: 24 bits a 800 kHz
+#define FRAMEBUFFER_US_POR_PIXEL 30
+// Pausa mínima com a linha em nível baixo para o WS2812 travar o frame
+// (o WS2812B mais recente pede 280 us; os antigos aceitam 50 us)
+#define FRAMEBUFFER_LATCH_US 280
+
+// Taxa máxima de frames para uma corrente de n pixels: dados mais latch
+#define FRAMEBUFFER_FPS_MAX(n) (1000000 / ((n) * FRAMEBUFFER_US_POR_PIXEL + FRAMEBUFFER_LATCH_US))
+
+// Tempo de barramento de um frame; as faixas transmitem ao mesmo tempo
+#define FRAMEBUFFER_US_POR_FRAME (TELA_PIXELS_POR_FAIXA * FRAMEBUFFER_US_POR_PIXEL + FRAMEBUFFER_LATCH_US)
+
+// Chamada (em contexto de IRQ) quando o DMA entrega o último pixel à FIFO.
+// Recebe o instante em que o frame estará travado nos LEDs.
+typedef void (*framebuffer_callback_t)(hal_tempo_t fim_latch);
+
+#if !HAL_HOST
+#include "hardware/pio.h"
+
+// Configura o canal de DMA ligado à FIFO TX da máquina de estados do pio_matrix
+// (do pio_matrix_paralelo, com TELA_FAIXAS > 1)
+void framebuffer_init(PIO pio, uint sm);
+#endif
+
+// Buffer de desenho (palavras GRB). O conteúdo não é preservado entre frames.
+uint32_t *framebuffer_desenho(void);
+
+// Envia o buffer de desenho e retorna imediatamente. Se o frame anterior
+// ainda estiver no fio, espera ele terminar e respeita o tempo de latch.
+// Um frame idêntico ao último transmitido não é reenviado: os LEDs já o mostram.
+void framebuffer_mostrar(void);
+
+// Envia um frame de um buffer externo (palavras GRB), lido direto pelo DMA sem
+// cópia. O buffer não pode mudar até o envio seguinte começar. O mesmo buffer
+// duas vezes seguidas não é reenviado (frames repetidos de uma tabela na flash).
+void framebuffer_mostrar_buffer(const uint32_t *pixels);
+
+// Último frame transmitido (palavras GRB), ou NULL antes do primeiro envio.
+// Vale até o envio seguinte.
+const uint32_t *framebuffer_enviado(void);
+
+// Indica se ainda há um frame sendo transferido pelo DMA
+bool framebuffer_ocupado(void);
+
+// Espera o frame atual sair por completo, incluindo o latch
+void framebuffer_aguardar(void);
+
+void framebuffer_set_callback(framebuffer_callback_t callback);
+
+// Contadores desde o início: frames transmitidos, frames iguais ao anterior que
+// não foram reenviados e o tempo de barramento (dados + latch) economizado
+typedef struct {
+    uint32_t enviados;
+    uint32_t pulados;
+    uint32_t us_economizados;
+} framebuffer_estatisticas_t;
+
+void framebuffer_estatisticas(framebuffer_estatisticas_t *estatisticas);
+
+#endif
@@ -0,0 +1,39 @@
+#include "framebuffer.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Saída do hal.h no RP2040: um canal de DMA alimentando a FIFO TX do pio_matrix
+
+static uint canal;
+static hal_saida_fim_t fim_envio = NULL;
+
+// Fim da transferência: o DMA já entregou tudo, mas a FIFO ainda está esvaziando
+static void framebuffer_dma_irq(void) {
+    if (!dma_channel_get_irq0_status(canal)) {
+        return; // IRQ de outro canal
+    }
+    dma_channel_acknowledge_irq0(canal);
+    fim_envio(time_us_64());
+}
+
+void framebuffer_init(PIO pio, uint sm) {
+    canal = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(canal);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    // Cada palavra só é escrita quando a FIFO TX da máquina de estados tem espaço
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    // Endereço de leitura e quantidade vêm a cada envio
+    dma_channel_configure(canal, &c, &pio->txf[sm], NULL, 0, false);
+
+    dma_channel_set_irq0_enabled(canal, true);
+    irq_add_shared_handler(DMA_IRQ_0, framebuffer_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void hal_saida_enviar(const uint32_t *palavras, uint n, hal_saida_fim_t fim) {
+    fim_envio = fim;
+    dma_channel_transfer_from_buffer_now(canal, palavras, n);
+}
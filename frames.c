@@ -0,0 +1,9 @@
+#include "frames.h"
+
+void frame_renderizar(uint32_t *pixels, frame_t frame, uint32_t cor) {
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        // Sem desvio: o bit vira uma máscara de 0 ou 0xFFFFFFFF
+        pixels[i] = cor & -(frame & 1);
+        frame >>= 1;
+    }
+}
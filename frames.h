@@ -0,0 +1,23 @@
+#ifndef FRAMES_H
+#define FRAMES_H
+
+#include <stdint.h>
+
+#define FRAME_LADO 5
+#define FRAME_PIXELS (FRAME_LADO * FRAME_LADO)
+
+// Frame 5x5 de LEDs ligados/desligados: o bit i corresponde ao pixel i de um
+// painel 5x5 (para desenhar em outra posição ou painel, ver tela_desenhar_frame)
+typedef uint32_t frame_t;
+
+// Inverte uma linha escrita da esquerda para a direita (0b10000 = primeiro pixel)
+#define FRAME_LINHA(x) ((((x) >> 4) & 1) | (((x) >> 2) & 2) | ((x) & 4) | (((x) << 2) & 8) | (((x) << 4) & 16))
+
+// Monta um frame a partir das 5 linhas, na mesma ordem em que os pixels são enviados
+#define FRAME(l0, l1, l2, l3, l4) ((frame_t)(FRAME_LINHA(l0) | FRAME_LINHA(l1) << 5 | \
+    FRAME_LINHA(l2) << 10 | FRAME_LINHA(l3) << 15 | FRAME_LINHA(l4) << 20))
+
+// Expande a máscara em FRAME_PIXELS palavras GRB: pixels ligados recebem a cor, os demais ficam apagados
+void frame_renderizar(uint32_t *pixels, frame_t frame, uint32_t cor);
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <string.h>
+#include "gravador.h"
+#include "framebuffer.h"
+#include "tela.h"
+
+// Maior registro: cabeçalho e, no pior delta, um varint de 3 bytes mais a
+// palavra por pixel. Um delta maior que o frame completo vira frame completo.
+#define CABECALHO_MAX (2 + 1 + 1 + 10 + 3)
+#define REGISTRO_MAX (CABECALHO_MAX + NUM_PIXELS * 6)
+#define CHAVE_TAMANHO(tempo_bytes) (2 + 1 + 1 + (tempo_bytes) + NUM_PIXELS * 3)
+
+_Static_assert(CABECALHO_MAX + NUM_PIXELS * 3 <= GRAVADOR_BYTES / 4, "GRAVADOR_BYTES pequeno demais para a tela");
+_Static_assert(REGISTRO_MAX <= 0xFFFF, "registro do gravador não cabe no campo de tamanho");
+
+// Anel de registros inteiros: o mais antigo começa em inicio
+static uint8_t anel[GRAVADOR_BYTES];
+static uint32_t inicio = 0;
+static uint32_t ocupados = 0;
+
+// Núcleo 1
+static uint8_t registro[REGISTRO_MAX];
+static uint32_t anterior[NUM_PIXELS];
+static bool tem_anterior = false;
+static hal_tempo_t instante_anterior;
+static uint desde_chave = 0;
+static char tecla_atual = 0;
+static gravador_estatisticas_t estatisticas;
+
+// Despejo no núcleo 0: enquanto ele lê o anel, o núcleo 1 não grava
+static volatile bool despejando = false;
+static volatile bool gravando = false;
+
+static uint escrever_varint(uint8_t *p, uint64_t v) {
+    uint n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint escrever_pixel(uint8_t *p, uint32_t palavra) {
+    p[0] = palavra >> 24;
+    p[1] = palavra >> 16;
+    p[2] = palavra >> 8;
+    return 3;
+}
+
+// Tipo, tecla e tempo; o tamanho é preenchido no fim
+static uint escrever_cabecalho(uint8_t tipo, uint64_t tempo) {
+    registro[2] = tipo;
+    registro[3] = tecla_atual;
+    return 4 + escrever_varint(registro + 4, tempo);
+}
+
+static uint montar_chave(const uint32_t *pixels, hal_tempo_t agora) {
+    uint n = escrever_cabecalho(GRAVADOR_CHAVE, agora);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        n += escrever_pixel(registro + n, pixels[i]);
+    }
+    return n;
+}
+
+// Só os pixels que mudaram; 0 se o frame completo for menor
+static uint montar_delta(const uint32_t *pixels, hal_tempo_t agora) {
+    uint n = escrever_cabecalho(GRAVADOR_DELTA, agora - instante_anterior);
+    uint tempo_bytes = n - 4;
+    // A quantidade vai na frente, mas só é conhecida no fim: reserva 3 bytes
+    uint pos_quantidade = n;
+    n += 3;
+    uint mudados = 0;
+    int ultimo = -1;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (pixels[i] != anterior[i]) {
+            n += escrever_varint(registro + n, i - ultimo - 1);
+            n += escrever_pixel(registro + n, pixels[i]);
+            ultimo = i;
+            mudados++;
+        }
+    }
+    uint8_t quantidade[3];
+    uint q = escrever_varint(quantidade, mudados);
+    memmove(registro + pos_quantidade + q, registro + pos_quantidade + 3, n - pos_quantidade - 3);
+    memcpy(registro + pos_quantidade, quantidade, q);
+    n -= 3 - q;
+    return n < CHAVE_TAMANHO(tempo_bytes) ? n : 0;
+}
+
+// Copia o registro para o anel, apagando os mais antigos até caber
+static void guardar(uint n) {
+    registro[0] = n;
+    registro[1] = n >> 8;
+    while (GRAVADOR_BYTES - ocupados < n) {
+        uint32_t tamanho = anel[inicio] | (uint32_t)anel[(inicio + 1) % GRAVADOR_BYTES] << 8;
+        inicio = (inicio + tamanho) % GRAVADOR_BYTES;
+        ocupados -= tamanho;
+        estatisticas.sobrescritos++;
+    }
+    uint32_t fim = (inicio + ocupados) % GRAVADOR_BYTES;
+    uint32_t ate_o_fim = GRAVADOR_BYTES - fim;
+    if (n <= ate_o_fim) {
+        memcpy(anel + fim, registro, n);
+    } else {
+        memcpy(anel + fim, registro, ate_o_fim);
+        memcpy(anel, registro + ate_o_fim, n - ate_o_fim);
+    }
+    ocupados += n;
+}
+
+void gravador_tecla(char tecla) {
+    tecla_atual = tecla;
+}
+
+void gravador_frame(const uint32_t *pixels, hal_tempo_t agora) {
+    gravando = true;
+    __sync_synchronize(); // Visto pelo núcleo 0 antes de olhar o despejo
+    if (despejando) {
+        // O delta seguinte continua certo: ele é calculado sobre o último gravado
+        estatisticas.ignorados++;
+        gravando = false;
+        return;
+    }
+
+    hal_tempo_t antes = hal_agora();
+    uint n = 0;
+    if (tem_anterior && desde_chave < GRAVADOR_CHAVE_A_CADA - 1) {
+        n = montar_delta(pixels, agora);
+    }
+    if (n) {
+        desde_chave++;
+    } else {
+        n = montar_chave(pixels, agora);
+        desde_chave = 0;
+        estatisticas.chaves++;
+    }
+    guardar(n);
+    memcpy(anterior, pixels, sizeof(anterior));
+    tem_anterior = true;
+    instante_anterior = agora;
+    estatisticas.frames++;
+    estatisticas.bytes = ocupados;
+
+    uint32_t us = hal_agora() - antes;
+    estatisticas.us_ultimo = us;
+    if (us > estatisticas.us_maximo) {
+        estatisticas.us_maximo = us;
+    }
+    __sync_synchronize(); // O anel está completo antes de liberar o despejo
+    gravando = false;
+}
+
+void gravador_despejar(void) {
+    despejando = true;
+    __sync_synchronize();
+    while (gravando) {
+        // O núcleo 1 termina o registro em poucos us
+    }
+
+    printf("GRAVADOR %u %u %u %lu\n", TELA_LARGURA, TELA_ALTURA, NUM_PIXELS, (unsigned long)ocupados);
+    uint i = 0;
+    for (uint y = 0; y < TELA_ALTURA; y++) {
+        for (uint x = 0; x < TELA_LARGURA; x++, i++) {
+            printf(i % 16 ? " %u" : "M %u", tela_indice(&tela, x, y));
+            if (i % 16 == 15) {
+                printf("\n");
+            }
+        }
+    }
+    if (i % 16) {
+        printf("\n");
+    }
+    for (uint32_t k = 0; k < ocupados; k++) {
+        printf(k % 32 ? "%02x" : "R %02x", anel[(inicio + k) % GRAVADOR_BYTES]);
+        if (k % 32 == 31 || k == ocupados - 1) {
+            printf("\n");
+        }
+    }
+    printf("FIM\n");
+
+    __sync_synchronize();
+    despejando = false;
+}
+
+void gravador_estatisticas(gravador_estatisticas_t *e) {
+    *e = estatisticas;
+}
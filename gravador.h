@@ -0,0 +1,71 @@
+#ifndef GRAVADOR_H
+#define GRAVADOR_H
+
+#include "hal.h"
+
+// Gravador da saída: cada frame transmitido vai para um anel fixo na RAM, como
+// diferença do frame anterior, com o instante do envio e a tecla do comando que
+// o produziu. Os registros mais antigos dão lugar aos novos. O anel é despejado
+// pelo stdio e decodificado por host/reproduzir.py. Só no build com
+// -DGRAVADOR=ON (que também liga o stdio pela USB); sem ela as chamadas abaixo
+// são vazias.
+#ifndef GRAVADOR
+#define GRAVADOR 0
+#endif
+
+#define GRAVADOR_BYTES 16384
+// Frame completo a cada tantos frames, para o começo do anel ser decodificável
+// depois que os registros antigos são sobrescritos
+#define GRAVADOR_CHAVE_A_CADA 32
+
+// Registro no anel (inteiros em varint LEB128, pixels em 3 bytes: G, R, B):
+//   tamanho (2 bytes, little-endian, o registro inteiro) | tipo | tecla | tempo | pixels
+// GRAVADOR_CHAVE: tempo = instante do envio em us; pixels = todos, na ordem do fio.
+// GRAVADOR_DELTA: tempo = us desde o registro anterior; pixels = quantidade e,
+// para cada pixel que mudou, a distância até o anterior que mudou (o primeiro
+// conta a partir de -1) e a palavra nova.
+#define GRAVADOR_CHAVE 'K'
+#define GRAVADOR_DELTA 'D'
+
+// Contadores desde o início
+typedef struct {
+    uint32_t frames;       // Frames gravados
+    uint32_t chaves;       // Dos quais completos
+    uint32_t sobrescritos; // Registros antigos apagados para abrir espaço
+    uint32_t ignorados;    // Frames enviados durante um despejo
+    uint32_t bytes;        // Ocupação atual do anel
+    uint32_t us_ultimo;    // Custo de gravar um frame
+    uint32_t us_maximo;
+} gravador_estatisticas_t;
+
+#if GRAVADOR
+
+// Núcleo 1. Tecla do comando que passa a produzir os frames (0 = nenhuma)
+void gravador_tecla(char tecla);
+
+// Núcleo 1. Frame (palavras GRB, NUM_PIXELS) que começa a ser transmitido agora
+void gravador_frame(const uint32_t *pixels, hal_tempo_t agora);
+
+// Núcleo 0. Escreve o anel no stdio, do registro mais antigo ao mais novo:
+//   GRAVADOR <largura> <altura> <pixels> <bytes>
+//   M <índice no fio de cada (x, y), linha a linha> (várias linhas)
+//   R <bytes do anel em hexadecimal> (várias linhas)
+//   FIM
+// Os frames enviados enquanto isso não são gravados.
+void gravador_despejar(void);
+
+void gravador_estatisticas(gravador_estatisticas_t *e);
+
+#else
+
+static inline void gravador_tecla(char tecla) {
+    (void)tecla;
+}
+static inline void gravador_frame(const uint32_t *pixels, hal_tempo_t agora) {
+    (void)pixels;
+    (void)agora;
+}
+
+#endif
+
+#endif
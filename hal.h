@@ -0,0 +1,64 @@
+#ifndef HAL_H
+#define HAL_H
+
+// Fronteira entre a lógica portátil (animações, cores, decodificação do teclado,
+// framebuffer) e o hardware. No RP2040 tudo vem do pico-sdk; com HAL_HOST (alvo
+// em host/), relógio, PIO e GPIO são simulados por host/hal_host.c.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Microssegundos desde o início
+typedef uint64_t hal_tempo_t;
+
+// Instante que nunca chega (o mesmo valor de at_the_end_of_time do pico-sdk)
+#define HAL_TEMPO_INFINITO ((hal_tempo_t)INT64_MAX)
+
+#if HAL_HOST
+
+typedef unsigned int uint;
+
+#ifndef count_of
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+
+hal_tempo_t hal_agora(void);
+
+// Espera ativa até o instante indicado
+void hal_esperar_ate(hal_tempo_t instante);
+
+static inline void tight_loop_contents(void) {
+}
+
+#else
+
+#include "pico/stdlib.h"
+
+static inline hal_tempo_t hal_agora(void) {
+    return time_us_64();
+}
+
+static inline void hal_esperar_ate(hal_tempo_t instante) {
+    busy_wait_until(from_us_since_boot(instante));
+}
+
+#endif
+
+// Chamada quando a última palavra de um envio entrou na FIFO (no RP2040, no IRQ
+// do DMA), com o instante em que isso aconteceu
+typedef void (*hal_saida_fim_t)(hal_tempo_t agora);
+
+// Começa a transmitir n palavras para a FIFO TX do pio_matrix e retorna sem
+// esperar; 'fim' é chamada ao fim da transferência. As palavras não podem mudar
+// até lá. No RP2040 é o DMA configurado por framebuffer_init (framebuffer_dma.c).
+void hal_saida_enviar(const uint32_t *palavras, uint n, hal_saida_fim_t fim);
+
+// Próximo retrato do teclado (16 bits, nível baixo = tecla pressionada) produzido
+// pela varredura; false quando não há retrato novo
+bool hal_teclado_ler(uint32_t *retrato);
+
+// Indica se não há retratos esperando para serem lidos
+bool hal_teclado_vazio(void);
+
+#endif
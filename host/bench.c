@@ -0,0 +1,430 @@
+// Microbenchmark do caminho de renderização/codificação dos frames no host.
+// Saída em CSV, uma linha por caso, para acompanhar regressões:
+//   caso,frames,ns_por_frame,instrucoes_por_frame,alocacoes
+// instrucoes_por_frame fica em -1 quando o kernel não libera o contador (perf_event_open).
+// Uso: bench [frames]   (padrão: 2000000)
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "hal_host.h"
+#include "animacoes.h"
+#include "framebuffer.h"
+#include "frames.h"
+#include "cor.h"
+#include "paralelo.h"
+#include "efeitos.h"
+#include "suave.h"
+#include "camadas.h"
+#include "texto.h"
+#include "gravador.h"
+
+// Alocações feitas pelo código medido (o alvo liga com -Wl,--wrap=malloc,...)
+static unsigned long alocacoes = 0;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t t);
+void *__real_realloc(void *p, size_t n);
+
+void *__wrap_malloc(size_t n) {
+    alocacoes++;
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t t) {
+    alocacoes++;
+    return __real_calloc(n, t);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+    alocacoes++;
+    return __real_realloc(p, n);
+}
+
+static int contador = -1;
+
+static void contador_abrir(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    contador = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void contador_iniciar(void) {
+    if (contador >= 0) {
+        ioctl(contador, PERF_EVENT_IOC_RESET, 0);
+        ioctl(contador, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static long long contador_ler(void) {
+    long long valor = -1;
+    if (contador >= 0) {
+        ioctl(contador, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(contador, &valor, sizeof(valor)) != sizeof(valor)) {
+            valor = -1;
+        }
+    }
+    return valor;
+}
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+// Impede que o compilador descarte os frames calculados
+static volatile uint32_t sumidouro;
+
+typedef void (*caso_t)(uint32_t frame);
+
+static void medir(const char *nome, caso_t caso, uint32_t frames) {
+    // Aquece caches e a tabela de gama
+    for (uint32_t i = 0; i < 1000; i++) {
+        caso(i);
+    }
+
+    alocacoes = 0;
+    contador_iniciar();
+    uint64_t inicio = agora_ns();
+    for (uint32_t i = 0; i < frames; i++) {
+        caso(i);
+    }
+    uint64_t fim = agora_ns();
+    long long instrucoes = contador_ler();
+
+    printf("%s,%u,%.2f,%.1f,%lu\n", nome, frames, (double)(fim - inicio) / frames,
+           instrucoes < 0 ? -1.0 : (double)instrucoes / frames, alocacoes);
+}
+
+// Codificação original: frame em double[25] e rgb_color em ponto flutuante por pixel
+
+static uint32_t rgb_color(double r, double g, double b) {
+    unsigned char R = r * 255;
+    unsigned char G = g * 255;
+    unsigned char B = b * 255;
+    return (G << 24) | (R << 16) | (B << 8);
+}
+
+static double frame_double[NUM_PIXELS];
+
+static void caso_double(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    double t = (double)(frame % 5) / 5;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pixels[i] = frame_double[i] ? rgb_color(1.0 - t, t, 0.0) : rgb_color(0, 0, 0);
+    }
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Ponto fixo, mas ainda calculando a cor dentro do laço de pixels
+
+static frame_t frame_mascara;
+
+static void caso_q8_por_pixel(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    uint16_t t = (frame % 5) * Q8(1.0) / 5;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pixels[i] = (frame_mascara >> i) & 1 ? cor_rgb_q8(Q8(1.0) - t, t, 0) : 0;
+    }
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Caminho atual: cor inteira calculada uma vez por frame e máscara expandida sem desvio
+
+static void caso_mascara(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    uint32_t cor = cor_grb(cor_interpolar(RGB(255, 0, 0), RGB(0, 255, 0), frame % 5, 5));
+    frame_renderizar(pixels, frame_mascara, cor);
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Um frame 5x5 em cada painel da tela, compostos no mesmo buffer do fio.
+// O custo deve crescer linearmente com o número de pixels (TELA_PAINEIS_X/Y).
+
+static void caso_paineis(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    uint32_t cor = cor_grb(cor_interpolar(RGB(255, 0, 0), RGB(0, 255, 0), frame % 5, 5));
+    for (uint py = 0; py < tela.paineis_y; py++) {
+        for (uint px = 0; px < tela.paineis_x; px++) {
+            int x, y;
+            tela_origem_painel(&tela, px, py, &x, &y);
+            tela_desenhar_frame(&tela, pixels, x, y, frame_mascara, cor);
+        }
+    }
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Transposição para o pio_matrix_paralelo: 8 faixas de 64 pixels (um painel 8x8 cada)
+
+#define TRANSP_PIXELS 64
+
+static uint32_t transp_pixels[PARALELO_MAX_FAIXAS * TRANSP_PIXELS];
+static uint32_t transp_planos[PARALELO_PALAVRAS_POR_PIXEL * TRANSP_PIXELS];
+static uint transp_faixas;
+
+static void caso_transposicao(uint32_t frame) {
+    transp_pixels[frame % count_of(transp_pixels)] = frame << 8;
+    paralelo_transpor(transp_pixels, transp_faixas, TRANSP_PIXELS, transp_planos);
+    sumidouro = transp_planos[frame % count_of(transp_planos)];
+}
+
+// Confere a transposição bit a bit contra a definição do formato (paralelo.h)
+static bool transposicao_confere(uint faixas) {
+    for (uint i = 0; i < count_of(transp_pixels); i++) {
+        transp_pixels[i] = (i * 0x9E3779B9u) & 0xFFFFFF00;
+    }
+    paralelo_transpor(transp_pixels, faixas, TRANSP_PIXELS, transp_planos);
+    for (uint i = 0; i < TRANSP_PIXELS; i++) {
+        for (uint plano = 0; plano < 24; plano++) {
+            uint32_t palavra = transp_planos[i * PARALELO_PALAVRAS_POR_PIXEL + plano / 4];
+            uint8_t byte = palavra >> (8 * (plano % 4));
+            for (uint l = 0; l < PARALELO_MAX_FAIXAS; l++) {
+                bool esperado = l < faixas && (transp_pixels[l * TRANSP_PIXELS + i] >> (31 - plano) & 1);
+                if (((byte >> l) & 1) != esperado) {
+                    fprintf(stderr, "transposicao: faixa %u pixel %u plano %u errado\n", l, i, plano);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Geradores procedurais: só o desenho de um passo, sem o envio
+
+static const efeito_t efeito_bench_aneis = {.tipo = &efeito_aneis, .comprimento = 2};
+static const efeito_t efeito_bench_cobra = {
+    .tipo = &efeito_cobra, .comprimento = 4, .voltas = 1, .caminho = efeito_caminho_borda};
+static const efeito_t efeito_bench_barra = {.tipo = &efeito_barra};
+static const efeito_t *efeito_atual;
+static uint32_t efeito_passos;
+
+static void caso_efeito(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    efeito_atual->tipo->desenhar(efeito_atual, pixels, frame % efeito_passos, 0x10203000);
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Modo suave: uma renovação (mistura em 16 bits, pontilhamento e codificação GRB)
+// no meio de uma transição longa entre dois frames-chave
+
+static uint32_t suave_chaves[2][NUM_PIXELS];
+
+static void caso_suave(uint32_t frame) {
+    hal_host_avancar_ate(hal_agora() + 1000000 / SUAVE_HZ);
+    if (!suave_ativo()) {
+        suave_chave(suave_chaves[frame & 1], 60000, hal_agora());
+    }
+    suave_renovar(hal_agora());
+    sumidouro = framebuffer_desenho()[frame % NUM_PIXELS];
+}
+
+// Compositor: n camadas de pixels, alternando os três modos, com alfa parcial.
+// O custo deve crescer linearmente com o número de camadas e de pixels.
+
+static uint32_t camadas_pixels[CAMADAS_MAX][NUM_PIXELS];
+static camada_t camadas_bench[CAMADAS_MAX];
+static uint camadas_n;
+
+static void caso_camadas(uint32_t frame) {
+    uint32_t *pixels = framebuffer_desenho();
+    camadas_pixels[frame % camadas_n][frame % NUM_PIXELS] = frame << 8;
+    camadas_compor(pixels, camadas_bench, camadas_n);
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Confere as operações SWAR canal a canal contra a conta direta em cada byte
+static bool camadas_confere(void) {
+    uint32_t estado = 1;
+    for (uint n = 0; n < 200000; n++) {
+        estado = estado * 1664525u + 1013904223u;
+        uint32_t a = estado;
+        estado = estado * 1664525u + 1013904223u;
+        uint32_t b = estado;
+        uint alfa = n % (CAMADA_OPACA + 1);
+        uint32_t soma = 0, maior = 0, escala = 0, mistura = 0;
+        for (uint k = 0; k < 32; k += 8) {
+            uint x = a >> k & 0xFF, y = b >> k & 0xFF;
+            soma |= (uint32_t)(x + y > 255 ? 255 : x + y) << k;
+            maior |= (uint32_t)(x > y ? x : y) << k;
+            escala |= (uint32_t)(x * alfa >> 8) << k;
+            mistura |= (uint32_t)((y * alfa + x * (CAMADA_OPACA - alfa)) >> 8) << k;
+        }
+        if (camadas_somar(a, b) != soma || camadas_maximo(a, b) != maior || camadas_escalar(a, alfa) != escala ||
+            camadas_misturar(a, b, alfa) != mistura) {
+            fprintf(stderr, "camadas: %08x %08x alfa %u errado\n", a, b, alfa);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Letreiro: um passo (deslocamento de uma coluna e desenho da janela). O custo
+// deve depender só da largura da tela, não do tamanho do texto.
+
+static char letreiro_longo[4096];
+static const char *letreiro_texto;
+static texto_letreiro_t letreiro;
+
+static void caso_letreiro(uint32_t frame) {
+    if (!texto_letreiro_avancar(&letreiro)) {
+        texto_letreiro_iniciar(&letreiro, letreiro_texto);
+    }
+    uint32_t *pixels = framebuffer_desenho();
+    texto_letreiro_desenhar(&letreiro, pixels, 0, 0x10203000);
+    sumidouro = pixels[frame % NUM_PIXELS];
+}
+
+// Gravador: custo de registrar um frame no anel, com poucos pixels mudando
+// (delta) ou todos (frame completo). É o limite do custo por frame enviado.
+
+static uint32_t gravador_pixels[NUM_PIXELS];
+static uint gravador_mudam;
+
+static void caso_gravador(uint32_t frame) {
+    for (uint i = 0; i < gravador_mudam; i++) {
+        gravador_pixels[(frame + i * 7) % NUM_PIXELS] = (frame * 2654435761u + i) << 8;
+    }
+    gravador_frame(gravador_pixels, frame * 1000ull);
+    sumidouro = gravador_pixels[frame % NUM_PIXELS];
+}
+
+// Passo completo de cada animação (renderização e envio ao PIO simulado)
+
+static animacao_passo_t animacao_atual;
+static uint32_t passos_atual;
+
+static void caso_animacao(uint32_t frame) {
+    animacao_atual(frame % passos_atual);
+}
+
+static uint32_t contar_passos(animacao_passo_t passo) {
+    uint32_t n = 0;
+    while (passo(n) != ANIMACAO_FIM) {
+        n++;
+    }
+    return n + 1; // O último passo também desenha (ou encerra) e faz parte do caminho
+}
+
+int main(int argc, char **argv) {
+    uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000000;
+
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        frame_double[i] = (i % 3) == 0;
+    }
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        frame_mascara |= (frame_t)((i % 3) == 0) << i;
+    }
+
+    contador_abrir();
+    printf("caso,frames,ns_por_frame,instrucoes_por_frame,alocacoes\n");
+
+    medir("codificacao_double", caso_double, frames);
+    medir("codificacao_q8_por_pixel", caso_q8_por_pixel, frames);
+    medir("codificacao_mascara", caso_mascara, frames);
+    medir("composicao_paineis", caso_paineis, frames);
+
+    static const uint faixas[] = {1, 4, 8};
+    for (uint i = 0; i < count_of(faixas); i++) {
+        if (!transposicao_confere(faixas[i])) {
+            return 1;
+        }
+        char nome[32];
+        snprintf(nome, sizeof(nome), "transposicao_%ux%u", faixas[i], TRANSP_PIXELS);
+        transp_faixas = faixas[i];
+        medir(nome, caso_transposicao, frames);
+    }
+
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        suave_chaves[0][i] = RGB(51, 0, 0) * (i % 2);
+        suave_chaves[1][i] = RGB(0, 128, 255) * (i % 3 == 0);
+    }
+    medir("suave_renovacao", caso_suave, frames);
+
+    if (!camadas_confere()) {
+        return 1;
+    }
+    for (uint k = 0; k < CAMADAS_MAX; k++) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            camadas_pixels[k][i] = (i + k) % 3 ? (i * 0x9E3779B9u + k) & 0xFFFFFF00 : 0;
+        }
+        camadas_bench[k] = (camada_t){.pixels = camadas_pixels[k], .modo = k % 3, .alfa = 96 + 20 * k};
+    }
+    for (uint n = 1; n <= CAMADAS_MAX; n *= 2) {
+        char nome[32];
+        snprintf(nome, sizeof(nome), "camadas_%u", n);
+        camadas_n = n;
+        medir(nome, caso_camadas, frames);
+    }
+
+    for (uint i = 0; i < sizeof(letreiro_longo) - 1; i++) {
+        letreiro_longo[i] = 'A' + i % 26;
+    }
+    static const struct {
+        const char *nome;
+        const char *texto;
+    } letreiros[] = {
+        {"letreiro_curto", "EMBARCATECH"},
+        {"letreiro_longo", letreiro_longo},
+    };
+    for (uint i = 0; i < count_of(letreiros); i++) {
+        letreiro_texto = letreiros[i].texto;
+        texto_letreiro_iniciar(&letreiro, letreiro_texto);
+        medir(letreiros[i].nome, caso_letreiro, frames);
+    }
+
+    gravador_mudam = 3;
+    medir("gravador_delta", caso_gravador, frames);
+    gravador_mudam = NUM_PIXELS;
+    medir("gravador_completo", caso_gravador, frames);
+
+    static const struct {
+        const char *nome;
+        const efeito_t *efeito;
+    } efeitos[] = {
+        {"efeito_aneis", &efeito_bench_aneis},
+        {"efeito_cobra", &efeito_bench_cobra},
+        {"efeito_barra", &efeito_bench_barra},
+    };
+
+    for (uint i = 0; i < count_of(efeitos); i++) {
+        efeito_atual = efeitos[i].efeito;
+        efeito_passos = efeito_atual->tipo->passos(efeito_atual);
+        medir(efeitos[i].nome, caso_efeito, frames);
+    }
+
+    static const struct {
+        const char *nome;
+        animacao_passo_t passo;
+    } animacoes[] = {
+        {"animacao_0", animacao_0},
+        {"animacao_1", animacao_1},
+        {"animacao_2", animacao_2},
+        {"animacao_cobra", animacao_cobra},
+        {"animacao_timer", animacao_timer},
+        {"animacao_e", animacao_e},
+        {"animacao_ondas", animacao_ondas},
+        {"animacao_9", animacao_9},
+        {"animacao_letreiro", animacao_letreiro},
+    };
+
+    for (uint i = 0; i < count_of(animacoes); i++) {
+        animacao_atual = animacoes[i].passo;
+        passos_atual = contar_passos(animacao_atual);
+        medir(animacoes[i].nome, caso_animacao, frames);
+    }
+    return 0;
+}
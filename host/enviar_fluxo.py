@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Envia frames ao vivo para o firmware no modo de fluxo (build com -DFLUXO=ON, tecla 7).
+
+Gera um arco-íris deslizando pela corrente e transmite pela porta serial da USB
+(CDC) no formato de fluxo.h: cabeçalho 'FX', sequência, ms, tamanho e
+Fletcher-16, seguido das palavras GRB na ordem do fio.
+
+Uso: enviar_fluxo.py [-p /dev/ttyACM0] [-n pixels] [-f fps] [-s segundos]
+"""
+
+import argparse
+import colorsys
+import os
+import struct
+import sys
+import termios
+import time
+import tty
+
+
+def soma(dados):
+    a = b = 0
+    for x in dados:
+        a = (a + x) % 255
+        b = (b + a) % 255
+    return b << 8 | a
+
+
+def pacote(seq, ms, palavras):
+    carga = struct.pack("<%dI" % len(palavras), *palavras)
+    return b"FX" + struct.pack("<4H", seq & 0xFFFF, ms, len(carga), soma(carga)) + carga
+
+
+def arco_iris(n, deslocamento):
+    palavras = []
+    for i in range(n):
+        r, g, b = colorsys.hsv_to_rgb(((i + deslocamento) % n) / n, 1.0, 0.1)
+        palavras.append(int(g * 255) << 24 | int(r * 255) << 16 | int(b * 255) << 8)
+    return palavras
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    p.add_argument("-p", "--porta", default="/dev/ttyACM0")
+    p.add_argument("-n", "--pixels", type=int, default=25, help="NUM_PIXELS do firmware")
+    p.add_argument("-f", "--fps", type=float, default=50.0)
+    p.add_argument("-s", "--segundos", type=float, default=10.0)
+    args = p.parse_args()
+
+    fd = os.open(args.porta, os.O_WRONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCOFLUSH)
+
+    ms = max(1, round(1000 / args.fps))
+    periodo = 1.0 / args.fps
+    proximo = time.monotonic()
+    total = int(args.segundos * args.fps)
+    for seq in range(total):
+        os.write(fd, pacote(seq, ms, arco_iris(args.pixels, seq)))
+        proximo += periodo
+        espera = proximo - time.monotonic()
+        if espera > 0:
+            time.sleep(espera)
+    os.close(fd)
+    print("%d frames enviados" % total, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,218 @@
+// Emulador do modo de fluxo (tecla 7) com um transporte simulado no lugar da USB.
+//
+// Cada cenário gera pacotes no formato de fluxo.h, com instantes de chegada
+// definidos (ritmo, variação, pacotes perdidos ou corrompidos), e os entrega em
+// pedaços de 64 bytes (o tamanho de um pacote USB full-speed) pelo mesmo
+// caminho do firmware: fluxo_destino/fluxo_recebido, lidos a cada LEITURA_MS
+// como faz o núcleo 0. A reprodução roda o passo modo_fluxo no relógio virtual.
+// Para cada cenário são conferidos a taxa de frames sustentada, os contadores
+// e o conteúdo e a ordem de cada frame que chega aos LEDs.
+//
+// Uso: fluxo_emulador
+// Sai com código 1 se algum cenário não tiver o resultado esperado.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal_host.h"
+#include "animacoes.h"
+#include "fluxo.h"
+
+#define LEITURA_MS 5 // Como em TarefaMatrix.c
+#define PACOTE_USB 64
+#define PACOTES 600
+#define PACOTE_BYTES (FLUXO_CABECALHO + FLUXO_TAMANHO)
+
+typedef struct {
+    const char *nome;
+    uint ms;           // Tempo de exibição gravado em cada pacote
+    uint intervalo_ms; // Ritmo de envio
+    uint variacao_ms;  // Atraso aleatório de 0 a variacao_ms em cada chegada
+    uint perder_cada;  // Um pacote em cada N não chega (0: nenhum)
+    uint corromper_cada; // Um pacote em cada N chega com um byte da carga trocado
+} cenario_t;
+
+static const cenario_t cenarios[] = {
+    {"constante", 20, 20, 0, 0, 0},
+    {"variacao", 20, 20, 12, 0, 0},
+    {"rapido", 20, 10, 0, 0, 0},
+    {"lento", 20, 25, 0, 0, 0},
+    {"falhas", 20, 20, 0, 50, 37},
+};
+
+// Bytes do transporte e o instante em que cada pacote fica disponível
+static uint8_t transporte[PACOTES * PACOTE_BYTES];
+static hal_tempo_t chegada[PACOTES];
+static uint pacotes;
+static size_t lidos;
+static uint perdas, corrupcoes; // Pacotes que o transporte perdeu e corrompeu
+
+// Frames vistos na saída
+static uint exibidos;
+static hal_tempo_t primeiro, ultimo;
+static int ultima_seq;
+static uint errados;
+
+// Pixel 0 com o número do pacote, os outros derivados dele
+static uint32_t pixel_do_pacote(uint seq, uint i) {
+    return (i ? seq * 2654435761u + i * 40503u : seq) << 8;
+}
+
+static void saida(hal_tempo_t inicio, const uint32_t *palavras, uint n) {
+    // O pixel 0 identifica o pacote; os outros precisam bater com ele
+    int seq = palavras[0] >> 8;
+    for (uint i = 0; i < n; i++) {
+        if (palavras[i] != pixel_do_pacote(seq, i)) {
+            errados++;
+            break;
+        }
+    }
+    if (seq <= ultima_seq) {
+        errados++; // Fora de ordem ou repetido
+    }
+    ultima_seq = seq;
+    if (!exibidos++) {
+        primeiro = inicio;
+    }
+    ultimo = inicio;
+}
+
+static uint32_t aleatorio(void) {
+    static uint32_t estado = 12345;
+    estado = estado * 1103515245u + 12345u;
+    return estado >> 16;
+}
+
+// Monta os pacotes do cenário e os instantes de chegada
+static void gerar(const cenario_t *c, hal_tempo_t inicio) {
+    perdas = corrupcoes = 0;
+    pacotes = 0;
+    hal_tempo_t anterior = inicio;
+    for (uint seq = 0; seq < PACOTES; seq++) {
+        // Nunca o último: uma perda só aparece no pacote seguinte
+        if (c->perder_cada && seq % c->perder_cada == c->perder_cada / 2) {
+            perdas++;
+            continue;
+        }
+        uint8_t *p = transporte + pacotes * PACOTE_BYTES;
+        uint8_t *carga = p + FLUXO_CABECALHO;
+        for (uint i = 0; i < NUM_PIXELS; i++) {
+            uint32_t palavra = pixel_do_pacote(seq, i);
+            for (uint b = 0; b < 4; b++) {
+                carga[i * 4 + b] = palavra >> (8 * b);
+            }
+        }
+        uint16_t soma = fluxo_soma(carga, FLUXO_TAMANHO);
+        uint16_t campos[4] = {seq, c->ms, FLUXO_TAMANHO, soma};
+        p[0] = FLUXO_MARCA0;
+        p[1] = FLUXO_MARCA1;
+        for (uint k = 0; k < 4; k++) {
+            p[2 + k * 2] = campos[k];
+            p[3 + k * 2] = campos[k] >> 8;
+        }
+        if (c->corromper_cada && seq % c->corromper_cada == c->corromper_cada - 1) {
+            carga[seq % FLUXO_TAMANHO] ^= 0x10;
+            corrupcoes++;
+        }
+
+        // A USB entrega em ordem: um pacote atrasado segura os seguintes
+        hal_tempo_t t = inicio + (hal_tempo_t)seq * c->intervalo_ms * 1000;
+        if (c->variacao_ms) {
+            t += aleatorio() % (c->variacao_ms * 1000 + 1);
+        }
+        if (t < anterior) {
+            t = anterior;
+        }
+        chegada[pacotes++] = anterior = t;
+    }
+    lidos = 0;
+}
+
+// Leitura do núcleo 0: tudo o que já chegou, direto para o destino do fluxo
+static void receber(hal_tempo_t agora) {
+    size_t disponivel = 0;
+    for (uint i = 0; i < pacotes && chegada[i] <= agora; i++) {
+        disponivel = (size_t)(i + 1) * PACOTE_BYTES;
+    }
+    while (lidos < disponivel) {
+        size_t quanto;
+        uint8_t *destino = fluxo_destino(&quanto);
+        size_t n = disponivel - lidos;
+        if (n > quanto) n = quanto;
+        if (n > PACOTE_USB) n = PACOTE_USB;
+        memcpy(destino, transporte + lidos, n);
+        lidos += n;
+        fluxo_recebido(n);
+    }
+}
+
+static bool perto(double valor, double esperado, double tolerancia) {
+    return valor > esperado * (1 - tolerancia) && valor < esperado * (1 + tolerancia);
+}
+
+int main(void) {
+    hal_host_definir_saida(saida);
+    bool ok = true;
+
+    printf("cenario,enviados,exibidos,fps,fps_esperado,descartados,atrasados,perdidos,corrompidos,resultado\n");
+    for (uint i = 0; i < count_of(cenarios); i++) {
+        const cenario_t *c = &cenarios[i];
+        fluxo_estatisticas_t antes, depois;
+        fluxo_estatisticas(&antes);
+
+        hal_tempo_t inicio = hal_agora();
+        gerar(c, inicio);
+        hal_tempo_t fim = chegada[pacotes - 1] + 200000;
+        exibidos = 0;
+        ultima_seq = -1;
+        errados = 0;
+
+        animacao_t animacao;
+        animacao_iniciar(&animacao, comando_da_tecla('7'), inicio);
+        hal_tempo_t leitura = inicio;
+        while (hal_agora() < fim) {
+            hal_tempo_t prazo = animacao_executar(&animacao, hal_agora());
+            if (leitura <= hal_agora()) {
+                receber(hal_agora());
+                leitura += LEITURA_MS * 1000;
+            }
+            hal_host_avancar_ate(prazo < leitura ? prazo : leitura);
+        }
+        animacao_parar(&animacao);
+        fluxo_estatisticas(&depois);
+
+        uint descartados = depois.descartados - antes.descartados;
+        uint atrasados = depois.atrasados - antes.atrasados;
+        uint perdidos = depois.perdidos - antes.perdidos;
+        uint corrompidos = depois.corrompidos - antes.corrompidos;
+        double fps = exibidos > 1 ? (exibidos - 1) * 1e6 / (double)(ultimo - primeiro) : 0;
+        // O ritmo de saída é o do pacote, a menos que o transmissor seja mais lento
+        uint periodo_ms = c->intervalo_ms > c->ms ? c->intervalo_ms : c->ms;
+        double esperado = 1000.0 / periodo_ms;
+
+        // Sempre: nenhum frame errado ou fora de ordem, cada pacote íntegro
+        // exibido ou descartado e cada falha do transporte contada
+        bool certo = !errados && exibidos + descartados == pacotes - corrupcoes &&
+                     depois.exibidos - antes.exibidos == exibidos && corrompidos == corrupcoes &&
+                     perdidos == perdas + corrupcoes;
+        // Sem falhas, a taxa do pacote (ou a do transmissor, se for mais lento) se sustenta
+        if (!c->perder_cada && !c->corromper_cada) {
+            certo = certo && perto(fps, esperado, 0.02);
+        }
+        if (c->intervalo_ms < c->ms) {
+            certo = certo && descartados > 0; // Fila cheia: o excesso é descartado
+        } else {
+            certo = certo && descartados == 0;
+        }
+        if (c->intervalo_ms > c->ms) {
+            certo = certo && atrasados > 1; // A fila esvazia e volta a encher
+        } else if (!c->perder_cada) {
+            certo = certo && atrasados == 1; // Só o fim do fluxo
+        }
+        ok = ok && certo;
+
+        printf("%s,%u,%u,%.2f,%.2f,%u,%u,%u,%u,%s\n", c->nome, pacotes, exibidos, fps, esperado, descartados,
+               atrasados, perdidos, corrompidos, certo ? "OK" : "ERRO");
+    }
+    return ok ? 0 : 1;
+}
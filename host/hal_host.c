@@ -0,0 +1,108 @@
+#include "hal_host.h"
+#include "framebuffer.h"
+#include "paralelo.h"
+#include "teclado.h"
+
+// Profundidade da FIFO RX unida do teclado.pio
+#define FIFO_TECLADO 8
+// Profundidade da FIFO TX unida do pio_matrix mais o OSR
+#define FIFO_SAIDA 9
+// Tempo de todas as palavras de um frame no fio, sem o latch
+#define US_POR_FRAME_DADOS (FRAMEBUFFER_US_POR_FRAME - FRAMEBUFFER_LATCH_US)
+
+static hal_tempo_t agora = 0;
+static hal_host_saida_t saida = NULL;
+
+static uint32_t fifo[FIFO_TECLADO];
+static uint fifo_inicio = 0;
+static uint fifo_qntd = 0;
+
+hal_tempo_t hal_agora(void) {
+    return agora;
+}
+
+void hal_host_avancar_ate(hal_tempo_t instante) {
+    if (instante > agora) {
+        agora = instante;
+    }
+}
+
+void hal_host_definir_saida(hal_host_saida_t nova) {
+    saida = nova;
+}
+
+// PIO simulado: o frame sai inteiro no instante do envio, e o DMA termina
+// quando a última palavra entra na FIFO, com o ritmo do fio. O relógio só
+// avança quando o framebuffer espera o latch.
+
+#if TELA_FAIXAS > 1
+// pio_matrix_paralelo: cada faixa recebe, de cada plano de bits (paralelo.h),
+// o bit da sua posição. Volta às palavras GRB, na ordem da corrente.
+static uint32_t nas_faixas[NUM_PIXELS];
+
+static const uint32_t *separar_faixas(const uint32_t *planos) {
+    for (uint i = 0; i < TELA_PIXELS_POR_FAIXA; i++) {
+        for (uint l = 0; l < TELA_FAIXAS; l++) {
+            uint32_t palavra = 0;
+            for (uint plano = 0; plano < 24; plano++) {
+                uint8_t byte = planos[i * PARALELO_PALAVRAS_POR_PIXEL + plano / 4] >> (8 * (plano % 4));
+                palavra |= (uint32_t)(byte >> l & 1) << (31 - plano);
+            }
+            nas_faixas[l * TELA_PIXELS_POR_FAIXA + i] = palavra;
+        }
+    }
+    return nas_faixas;
+}
+#endif
+
+void hal_saida_enviar(const uint32_t *palavras, uint n, hal_saida_fim_t fim) {
+    if (saida) {
+#if TELA_FAIXAS > 1
+        saida(agora, separar_faixas(palavras), NUM_PIXELS);
+#else
+        saida(agora, palavras, n);
+#endif
+    }
+    uint pendentes = n < FIFO_SAIDA ? n : FIFO_SAIDA;
+    fim(agora + (hal_tempo_t)(n - pendentes) * US_POR_FRAME_DADOS / n);
+}
+
+void hal_esperar_ate(hal_tempo_t instante) {
+    hal_host_avancar_ate(instante);
+}
+
+// Teclado sobre uma FIFO simulada
+
+bool hal_host_teclado_empurrar(uint32_t retrato) {
+    if (fifo_qntd == FIFO_TECLADO) {
+        return false;
+    }
+    fifo[(fifo_inicio + fifo_qntd++) % FIFO_TECLADO] = retrato;
+    return true;
+}
+
+uint32_t hal_host_retrato(char tecla) {
+    for (uint linha = 0; linha < TECLADO_LINHAS; linha++) {
+        for (uint coluna = 0; coluna < TECLADO_COLUNAS; coluna++) {
+            if (teclado[linha][coluna] == tecla) {
+                // Mesma posição de bit decodificada por teclado_evento
+                return 0xFFFF & ~(1u << ((3 - linha) * 4 + (3 - coluna)));
+            }
+        }
+    }
+    return 0xFFFF;
+}
+
+bool hal_teclado_ler(uint32_t *retrato) {
+    if (fifo_qntd == 0) {
+        return false;
+    }
+    *retrato = fifo[fifo_inicio];
+    fifo_inicio = (fifo_inicio + 1) % FIFO_TECLADO;
+    fifo_qntd--;
+    return true;
+}
+
+bool hal_teclado_vazio(void) {
+    return fifo_qntd == 0;
+}
@@ -0,0 +1,23 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include "hal.h"
+
+// Relógio virtual: só anda quando o código manda, então a simulação roda mais
+// rápido que o tempo real e é sempre reproduzível
+void hal_host_avancar_ate(hal_tempo_t instante);
+
+// PIO simulado: recebe cada frame enviado pelo framebuffer no instante em que
+// começaria a sair no fio, como os LEDs o recebem (palavras GRB na ordem da
+// corrente; com várias faixas, os planos de bits já separados por faixa)
+typedef void (*hal_host_saida_t)(hal_tempo_t inicio, const uint32_t *palavras, uint n);
+void hal_host_definir_saida(hal_host_saida_t saida);
+
+// Teclado simulado: coloca um retrato na FIFO (mesmo formato do teclado.pio).
+// Retorna false se a FIFO de 8 posições estiver cheia.
+bool hal_host_teclado_empurrar(uint32_t retrato);
+
+// Retrato com só a tecla indicada pressionada (todas soltas para 0)
+uint32_t hal_host_retrato(char tecla);
+
+#endif
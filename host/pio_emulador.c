@@ -0,0 +1,437 @@
+// Emulador ciclo a ciclo do programa pio_matrix para verificar a forma de onda do WS2812.
+//
+// Monta o arquivo .pio (subconjunto: out, jmp, set, nop, rótulos, delays,
+// .wrap_target/.wrap), executa a máquina de estados com autopull de 24 bits e
+// deslocamento à esquerda, como em pio_matrix_program_init, e grava o nível do
+// pino a cada ciclo. A forma de onda é então decodificada de volta em pixels GRB
+// e cada pulso é conferido contra as tolerâncias do WS2812B (T0H, T1H, T0L, T1L
+// e reset). Os frames vêm das animações reais, rodando sobre o HAL do host.
+//
+// Uso: pio_emulador [-p arquivo.pio] [-f hz_do_pio] [-l latch_us] [teclas]
+//   padrão: o pio_matrix.pio do repositório, 8000000 Hz, FRAMEBUFFER_LATCH_US, teclas 1234569
+// Sai com código 1 se algum pulso, pausa ou pixel estiver errado.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "hal_host.h"
+#include "animacoes.h"
+#include "framebuffer.h"
+#include "teclado.h"
+
+// Tolerâncias do WS2812B, em ns
+#define T0H_NS 400
+#define T1H_NS 800
+#define T0L_NS 850
+#define T1L_NS 450
+#define TOLERANCIA_NS 150
+#define RESET_MIN_NS 50000 // Pausa que trava o frame (os WS2812B mais novos pedem 280 us)
+
+#ifndef PIO_MATRIX_ARQUIVO
+#define PIO_MATRIX_ARQUIVO "pio_matrix.pio"
+#endif
+
+#define MAX_INSTRUCOES 32
+#define MAX_ROTULOS 32
+#define MAX_FRAMES 4096
+
+// Programa montado
+
+enum { OP_JMP, OP_OUT, OP_SET, OP_NOP };
+enum { DEST_PINS, DEST_X, DEST_Y, DEST_NULL };
+enum { JMP_SEMPRE, JMP_NAO_X, JMP_X_DEC, JMP_NAO_Y, JMP_Y_DEC, JMP_X_DIF_Y, JMP_NAO_OSRE };
+
+typedef struct {
+    int op;
+    int destino;  // out/set
+    int condicao; // jmp
+    uint32_t valor; // bits do out, valor do set ou alvo do jmp
+    int atraso;
+    char rotulo[32]; // alvo do jmp, resolvido depois da montagem
+} instrucao_t;
+
+static instrucao_t programa[MAX_INSTRUCOES];
+static int num_instrucoes = 0;
+static int wrap_target = 0;
+static int wrap = -1;
+
+static struct {
+    char nome[32];
+    int endereco;
+} rotulos[MAX_ROTULOS];
+static int num_rotulos = 0;
+
+static int erro_montagem(int linha, const char *msg) {
+    fprintf(stderr, "pio:%d: %s\n", linha, msg);
+    return 0;
+}
+
+static int destino(const char *s) {
+    if (!strcmp(s, "pins")) return DEST_PINS;
+    if (!strcmp(s, "x")) return DEST_X;
+    if (!strcmp(s, "y")) return DEST_Y;
+    if (!strcmp(s, "null")) return DEST_NULL;
+    return -1;
+}
+
+static int montar(const char *caminho) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        return 0;
+    }
+
+    char linha[256];
+    int num_linha = 0;
+    while (fgets(linha, sizeof(linha), f)) {
+        num_linha++;
+        if (!strncmp(linha, "%", 1)) {
+            break; // Bloco c-sdk
+        }
+        char *c = strpbrk(linha, ";\r\n");
+        if (c) {
+            *c = 0;
+        }
+
+        // Delay entre colchetes
+        int atraso = 0;
+        char *colchete = strchr(linha, '[');
+        if (colchete) {
+            atraso = atoi(colchete + 1);
+            *colchete = 0;
+        }
+
+        // Troca vírgulas por espaços e separa os campos
+        for (c = linha; *c; c++) {
+            if (*c == ',') *c = ' ';
+        }
+        char campos[4][32] = {{0}};
+        int n = sscanf(linha, "%31s %31s %31s %31s", campos[0], campos[1], campos[2], campos[3]);
+        if (n <= 0) {
+            continue;
+        }
+
+        size_t tam = strlen(campos[0]);
+        if (campos[0][tam - 1] == ':') {
+            if (num_rotulos == MAX_ROTULOS) return erro_montagem(num_linha, "rótulos demais");
+            campos[0][tam - 1] = 0;
+            strcpy(rotulos[num_rotulos].nome, campos[0]);
+            rotulos[num_rotulos++].endereco = num_instrucoes;
+            continue;
+        }
+        if (!strcmp(campos[0], ".wrap_target")) {
+            wrap_target = num_instrucoes;
+            continue;
+        }
+        if (!strcmp(campos[0], ".wrap")) {
+            wrap = num_instrucoes - 1;
+            continue;
+        }
+        if (!strcmp(campos[0], ".side_set")) {
+            return erro_montagem(num_linha, "side-set não suportado");
+        }
+        if (campos[0][0] == '.') {
+            continue; // .program e afins
+        }
+
+        if (num_instrucoes == MAX_INSTRUCOES) return erro_montagem(num_linha, "instruções demais");
+        instrucao_t *i = &programa[num_instrucoes++];
+        memset(i, 0, sizeof(*i));
+        i->atraso = atraso;
+
+        if (!strcmp(campos[0], "nop")) {
+            i->op = OP_NOP;
+        } else if (!strcmp(campos[0], "out") && n == 3) {
+            i->op = OP_OUT;
+            i->destino = destino(campos[1]);
+            i->valor = atoi(campos[2]);
+            if (i->destino < 0 || i->valor < 1 || i->valor > 32) return erro_montagem(num_linha, "out inválido");
+        } else if (!strcmp(campos[0], "set") && n == 3) {
+            i->op = OP_SET;
+            i->destino = destino(campos[1]);
+            i->valor = strtoul(campos[2], NULL, 0);
+            if (i->destino < 0 || i->destino == DEST_NULL) return erro_montagem(num_linha, "set inválido");
+        } else if (!strcmp(campos[0], "jmp") && (n == 2 || n == 3)) {
+            i->op = OP_JMP;
+            const char *cond = n == 3 ? campos[1] : "";
+            if (!*cond) i->condicao = JMP_SEMPRE;
+            else if (!strcmp(cond, "!x")) i->condicao = JMP_NAO_X;
+            else if (!strcmp(cond, "x--")) i->condicao = JMP_X_DEC;
+            else if (!strcmp(cond, "!y")) i->condicao = JMP_NAO_Y;
+            else if (!strcmp(cond, "y--")) i->condicao = JMP_Y_DEC;
+            else if (!strcmp(cond, "x!=y")) i->condicao = JMP_X_DIF_Y;
+            else if (!strcmp(cond, "!osre")) i->condicao = JMP_NAO_OSRE;
+            else return erro_montagem(num_linha, "condição de jmp não suportada");
+            strcpy(i->rotulo, campos[n - 1]);
+        } else {
+            return erro_montagem(num_linha, "instrução não suportada");
+        }
+    }
+    fclose(f);
+
+    if (wrap < 0) {
+        wrap = num_instrucoes - 1;
+    }
+    for (int i = 0; i < num_instrucoes; i++) {
+        if (programa[i].op != OP_JMP) continue;
+        int r;
+        for (r = 0; r < num_rotulos && strcmp(rotulos[r].nome, programa[i].rotulo); r++) {
+        }
+        if (r == num_rotulos) {
+            fprintf(stderr, "pio: rótulo desconhecido '%s'\n", programa[i].rotulo);
+            return 0;
+        }
+        programa[i].valor = rotulos[r].endereco;
+    }
+    return num_instrucoes > 0;
+}
+
+// Forma de onda: trechos de nível constante, em ciclos do PIO
+
+typedef struct {
+    uint8_t nivel;
+    uint64_t ciclos;
+} trecho_t;
+
+static trecho_t *onda = NULL;
+static size_t onda_qntd = 0;
+static size_t onda_cap = 0;
+
+static void onda_adicionar(uint8_t nivel, uint64_t ciclos) {
+    if (onda_qntd && onda[onda_qntd - 1].nivel == nivel) {
+        onda[onda_qntd - 1].ciclos += ciclos;
+        return;
+    }
+    if (onda_qntd == onda_cap) {
+        onda_cap = onda_cap ? onda_cap * 2 : 4096;
+        onda = realloc(onda, onda_cap * sizeof(*onda));
+    }
+    onda[onda_qntd].nivel = nivel;
+    onda[onda_qntd++].ciclos = ciclos;
+}
+
+// Máquina de estados
+
+static struct {
+    int pc;
+    uint32_t x, y, osr;
+    int osr_contagem; // Bits já deslocados do OSR
+    uint8_t pino;
+} sm;
+
+#define AUTOPULL_BITS 24
+
+// Executa até a FIFO acabar e a máquina parar num out sem dados
+static void executar(const uint32_t *fifo, uint n) {
+    uint lidos = 0;
+    while (true) {
+        instrucao_t *i = &programa[sm.pc];
+        int proximo = sm.pc == wrap ? wrap_target : sm.pc + 1;
+
+        switch (i->op) {
+        case OP_OUT: {
+            if (sm.osr_contagem >= AUTOPULL_BITS) {
+                if (lidos == n) {
+                    return; // Parado no autopull: o pino mantém o nível (sticky)
+                }
+                sm.osr = fifo[lidos++];
+                sm.osr_contagem = 0;
+            }
+            uint32_t valor = i->valor == 32 ? sm.osr : sm.osr >> (32 - i->valor);
+            sm.osr = i->valor == 32 ? 0 : sm.osr << i->valor;
+            sm.osr_contagem += i->valor;
+            if (i->destino == DEST_X) sm.x = valor;
+            else if (i->destino == DEST_Y) sm.y = valor;
+            else if (i->destino == DEST_PINS) sm.pino = valor & 1;
+            break;
+        }
+        case OP_SET:
+            if (i->destino == DEST_X) sm.x = i->valor;
+            else if (i->destino == DEST_Y) sm.y = i->valor;
+            else sm.pino = i->valor & 1;
+            break;
+        case OP_JMP: {
+            bool salta = false;
+            switch (i->condicao) {
+            case JMP_SEMPRE: salta = true; break;
+            case JMP_NAO_X: salta = sm.x == 0; break;
+            case JMP_X_DEC: salta = sm.x-- != 0; break;
+            case JMP_NAO_Y: salta = sm.y == 0; break;
+            case JMP_Y_DEC: salta = sm.y-- != 0; break;
+            case JMP_X_DIF_Y: salta = sm.x != sm.y; break;
+            case JMP_NAO_OSRE: salta = sm.osr_contagem < AUTOPULL_BITS; break;
+            }
+            if (salta) proximo = i->valor;
+            break;
+        }
+        default:
+            break;
+        }
+
+        onda_adicionar(sm.pino, 1 + i->atraso);
+        sm.pc = proximo;
+    }
+}
+
+// Frames emitidos pelas animações
+
+static uint32_t (*frames)[NUM_PIXELS] = NULL;
+static uint num_frames = 0;
+
+static void guardar_frame(hal_tempo_t inicio, const uint32_t *palavras, uint n) {
+    (void)inicio;
+    if (num_frames < MAX_FRAMES) {
+        memcpy(frames[num_frames++], palavras, n * sizeof(uint32_t));
+    }
+}
+
+static void gerar_frames(const char *teclas) {
+    hal_host_definir_saida(guardar_frame);
+    animacao_t animacao;
+    animacao_parar(&animacao);
+    for (const char *t = teclas; *t; t++) {
+        animacao_passo_t comando = comando_da_tecla(*t);
+        if (!comando) continue;
+        animacao_iniciar(&animacao, comando, hal_agora());
+        hal_tempo_t prazo;
+        while ((prazo = animacao_executar(&animacao, hal_agora())) != HAL_TEMPO_INFINITO) {
+            hal_host_avancar_ate(prazo);
+        }
+    }
+}
+
+// Decodificação e verificação
+
+typedef struct {
+    uint64_t min, max;
+    uint64_t qntd;
+} faixa_t;
+
+static void faixa_somar(faixa_t *f, uint64_t ns) {
+    if (!f->qntd || ns < f->min) f->min = ns;
+    if (!f->qntd || ns > f->max) f->max = ns;
+    f->qntd++;
+}
+
+static void faixa_imprimir(const char *nome, const faixa_t *f, int nominal) {
+    if (f->qntd) {
+        printf("  %s: %llu..%llu ns (nominal %d +- %d), %llu pulsos\n", nome, (unsigned long long)f->min,
+               (unsigned long long)f->max, nominal, TOLERANCIA_NS, (unsigned long long)f->qntd);
+    }
+}
+
+static bool dentro(uint64_t ns, int nominal) {
+    return ns + TOLERANCIA_NS >= (uint64_t)nominal && ns <= (uint64_t)nominal + TOLERANCIA_NS;
+}
+
+int main(int argc, char **argv) {
+    const char *arquivo = PIO_MATRIX_ARQUIVO;
+    double hz = 8000000.0;
+    uint32_t latch_us = FRAMEBUFFER_LATCH_US;
+    const char *teclas = "1234569";
+
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "-p") && a + 1 < argc) arquivo = argv[++a];
+        else if (!strcmp(argv[a], "-f") && a + 1 < argc) hz = atof(argv[++a]);
+        else if (!strcmp(argv[a], "-l") && a + 1 < argc) latch_us = strtoul(argv[++a], NULL, 10);
+        else teclas = argv[a];
+    }
+
+    if (!montar(arquivo)) {
+        return 2;
+    }
+
+    frames = calloc(MAX_FRAMES, sizeof(*frames));
+    gerar_frames(teclas);
+
+    // Cada frame é entregue inteiro à FIFO (como faz o DMA); entre frames a
+    // máquina fica parada no autopull durante o latch
+    double ns_por_ciclo = 1e9 / hz;
+    uint64_t ciclos_latch = (uint64_t)(latch_us * 1000.0 / ns_por_ciclo + 0.5);
+    sm.pc = 0;
+    sm.osr_contagem = AUTOPULL_BITS;
+    onda_adicionar(0, ciclos_latch);
+    for (uint f = 0; f < num_frames; f++) {
+        executar(frames[f], NUM_PIXELS);
+        onda_adicionar(sm.pino, ciclos_latch);
+    }
+
+    // Decodifica: cada pulso alto é um bit, a duração do alto diz se é 0 ou 1
+    faixa_t t0h = {0}, t1h = {0}, t0l = {0}, t1l = {0}, reset = {0};
+    uint erros = 0, frame = 0, pixel = 0, bit = 0;
+    uint32_t grb = 0;
+    uint64_t ciclos_total = 0;
+
+    for (size_t s = 0; s < onda_qntd; s++) {
+        ciclos_total += onda[s].ciclos;
+        if (!onda[s].nivel) {
+            continue;
+        }
+        uint64_t alto = (uint64_t)(onda[s].ciclos * ns_por_ciclo + 0.5);
+        uint64_t baixo = s + 1 < onda_qntd ? (uint64_t)(onda[s + 1].ciclos * ns_por_ciclo + 0.5) : RESET_MIN_NS;
+        bool um = alto * 2 > T0H_NS + T1H_NS;
+        bool fim_frame = baixo >= RESET_MIN_NS;
+
+        faixa_somar(um ? &t1h : &t0h, alto);
+        if (!dentro(alto, um ? T1H_NS : T0H_NS)) {
+            if (erros++ < 10) printf("frame %u pixel %u bit %u: alto de %llu ns\n", frame, pixel, bit, (unsigned long long)alto);
+        }
+        if (fim_frame) {
+            faixa_somar(&reset, baixo);
+        } else {
+            faixa_somar(um ? &t1l : &t0l, baixo);
+            if (!dentro(baixo, um ? T1L_NS : T0L_NS)) {
+                if (erros++ < 10) printf("frame %u pixel %u bit %u: baixo de %llu ns\n", frame, pixel, bit, (unsigned long long)baixo);
+            }
+        }
+
+        grb = grb << 1 | um;
+        if (++bit == 24) {
+            if (frame >= num_frames || pixel >= NUM_PIXELS || frames[frame][pixel] >> 8 != grb) {
+                if (erros++ < 10) printf("frame %u pixel %u: decodificado %06x\n", frame, pixel, grb);
+            }
+            bit = 0;
+            grb = 0;
+            pixel++;
+        }
+        if (fim_frame) {
+            if (bit || pixel != NUM_PIXELS) {
+                if (erros++ < 10) printf("frame %u: latch depois de %u pixels e %u bits\n", frame, pixel, bit);
+            }
+            frame++;
+            pixel = 0;
+            bit = 0;
+        }
+    }
+    if (frame != num_frames) {
+        erros++;
+        printf("%u frames decodificados de %u enviados\n", frame, num_frames);
+    }
+
+    double segundos = ciclos_total * ns_por_ciclo / 1e9;
+    printf("%s a %.0f Hz: %u instruções, %u frames de %d pixels\n", arquivo, hz, num_instrucoes, num_frames, NUM_PIXELS);
+    faixa_imprimir("T0H", &t0h, T0H_NS);
+    faixa_imprimir("T1H", &t1h, T1H_NS);
+    faixa_imprimir("T0L", &t0l, T0L_NS);
+    faixa_imprimir("T1L", &t1l, T1L_NS);
+    if (reset.qntd) {
+        printf("  reset: %llu..%llu ns (minimo %d)\n", (unsigned long long)reset.min, (unsigned long long)reset.max, RESET_MIN_NS);
+    }
+    printf("  vazao: %.0f pixels/s (%.1f frames/s com latch de %u us)\n",
+           segundos > 0 ? num_frames * NUM_PIXELS / segundos : 0.0, segundos > 0 ? num_frames / segundos : 0.0, latch_us);
+    // Taxa máxima para correntes maiores, com o tempo por pixel medido acima
+    if (num_frames) {
+        double ns_por_pixel = (ciclos_total - ciclos_latch * (num_frames + 1)) * ns_por_ciclo / (num_frames * NUM_PIXELS);
+        static const uint correntes[] = {25, 64, 100, 256, 400, 1024};
+        for (uint i = 0; i < count_of(correntes); i++) {
+            printf("  corrente de %4u pixels: %6.1f frames/s\n", correntes[i],
+                   1e9 / (correntes[i] * ns_por_pixel + latch_us * 1000.0));
+        }
+    }
+    printf("%s: %u erros\n", erros ? "FALHOU" : "OK", erros);
+
+    free(frames);
+    free(onda);
+    return erros ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Decodifica o despejo do gravador (build com -DGRAVADOR=ON) e reproduz os frames no terminal.
+
+O despejo sai pela USB ao enviar 'G' ao firmware, no formato de gravador.h;
+pode vir no meio de outras linhas do log (a última ocorrência é usada). No host,
+`simular -g <teclas>` produz o mesmo despejo.
+
+Uso: reproduzir.py [arquivo] [-v velocidade] [-q | -e]
+  -v  velocidade da reprodução (1 = tempo real, 10 = dez vezes mais rápido)
+  -q  só imprime os frames decodificados, no formato do simular
+  -e  só imprime as estatísticas de tempo
+"""
+
+import argparse
+import sys
+import time
+
+CHAVE = ord("K")
+DELTA = ord("D")
+
+
+def ler_despejo(linhas):
+    cabecalho, mapa, dados = None, [], bytearray()
+    completo = None
+    for linha in linhas:
+        campos = linha.split()
+        if not campos:
+            continue
+        if campos[0] == "GRAVADOR" and len(campos) == 5:
+            cabecalho, mapa, dados = [int(c) for c in campos[1:]], [], bytearray()
+        elif cabecalho is None:
+            continue
+        elif campos[0] == "M":
+            mapa.extend(int(c) for c in campos[1:])
+        elif campos[0] == "R" and len(campos) == 2:
+            dados.extend(bytes.fromhex(campos[1]))
+        elif campos[0] == "FIM":
+            completo = (cabecalho, mapa, bytes(dados))
+            cabecalho = None
+    if completo is None:
+        sys.exit("nenhum despejo completo do gravador na entrada")
+    (largura, altura, pixels, tamanho), mapa, dados = completo
+    if len(dados) != tamanho or len(mapa) != largura * altura:
+        sys.exit("despejo truncado: %d de %d bytes, %d de %d pixels no mapa"
+                 % (len(dados), tamanho, len(mapa), largura * altura))
+    return largura, altura, pixels, mapa, dados
+
+
+def varint(dados, pos):
+    valor, desloc = 0, 0
+    while True:
+        b = dados[pos]
+        pos += 1
+        valor |= (b & 0x7F) << desloc
+        desloc += 7
+        if b < 0x80:
+            return valor, pos
+
+
+def palavra(dados, pos):
+    return dados[pos] << 24 | dados[pos + 1] << 16 | dados[pos + 2] << 8
+
+
+def decodificar(pixels, dados):
+    """Frames (instante em us, tecla, palavras GRB) a partir do primeiro frame completo."""
+    frames = []
+    atual = None
+    instante = 0
+    pos = 0
+    while pos + 2 <= len(dados):
+        tamanho = dados[pos] | dados[pos + 1] << 8
+        if tamanho < 5 or pos + tamanho > len(dados):
+            sys.exit("registro inválido no byte %d" % pos)
+        tipo, tecla = dados[pos + 2], dados[pos + 3]
+        tempo, p = varint(dados, pos + 4)
+        if tipo == CHAVE:
+            instante = tempo
+            atual = [palavra(dados, p + 3 * i) for i in range(pixels)]
+        elif tipo == DELTA:
+            if atual is None:
+                pos += tamanho  # Anterior ao primeiro frame completo que sobrou no anel
+                continue
+            instante += tempo
+            atual = list(atual)
+            n, p = varint(dados, p)
+            i = -1
+            for _ in range(n):
+                distancia, p = varint(dados, p)
+                i += distancia + 1
+                atual[i] = palavra(dados, p)
+                p += 3
+        else:
+            sys.exit("tipo de registro desconhecido %d no byte %d" % (tipo, pos))
+        frames.append((instante, chr(tecla) if tecla else "-", atual))
+        pos += tamanho
+    return frames
+
+
+def percentil(ordenados, p):
+    return ordenados[max(0, -(-len(ordenados) * p // 100) - 1)]
+
+
+def estatisticas(frames, dados):
+    if not frames:
+        print("nenhum frame decodificável")
+        return
+    duracao = frames[-1][0] - frames[0][0]
+    print("%d frames em %.3f s, %d bytes (%.1f por frame)"
+          % (len(frames), duracao / 1e6, len(dados), len(dados) / len(frames)))
+    intervalos = sorted(b[0] - a[0] for a, b in zip(frames, frames[1:]))
+    if intervalos:
+        print("intervalo entre frames: min %d us, mediana %d us, p99 %d us, max %d us, media %.1f frames/s"
+              % (intervalos[0], percentil(intervalos, 50), percentil(intervalos, 99), intervalos[-1],
+                 (len(frames) - 1) * 1e6 / duracao if duracao else 0))
+    # Por tecla: frames e tempo até o frame seguinte (o último não tem duração)
+    por_tecla = {}
+    for k, (instante, tecla, _) in enumerate(frames):
+        n, tempo = por_tecla.get(tecla, (0, 0))
+        fim = frames[k + 1][0] if k + 1 < len(frames) else instante
+        por_tecla[tecla] = (n + 1, tempo + fim - instante)
+    for tecla in sorted(por_tecla):
+        n, tempo = por_tecla[tecla]
+        print("tecla %s: %d frames, %.3f s" % (tecla, n, tempo / 1e6))
+
+
+def reproduzir(frames, largura, altura, mapa, velocidade):
+    saida = sys.stdout
+    saida.write("\x1b[2J")
+    inicio_real = time.monotonic()
+    inicio = frames[0][0] if frames else 0
+    for k, (instante, tecla, palavras) in enumerate(frames):
+        espera = (instante - inicio) / 1e6 / velocidade - (time.monotonic() - inicio_real)
+        if espera > 0:
+            time.sleep(espera)
+        linhas = ["\x1b[H%9.3f s  tecla %s  frame %d/%d\x1b[K" % ((instante - inicio) / 1e6, tecla, k + 1, len(frames))]
+        for y in range(altura):
+            linha = []
+            for x in range(largura):
+                w = palavras[mapa[y * largura + x]]
+                g, r, b = w >> 24, w >> 16 & 0xFF, w >> 8 & 0xFF
+                linha.append("\x1b[38;2;%d;%d;%dm██" % (r, g, b) if w else "\x1b[0m··")
+            linhas.append("".join(linha) + "\x1b[0m")
+        saida.write("\n".join(linhas) + "\n")
+        saida.flush()
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    p.add_argument("arquivo", nargs="?", help="log com o despejo (padrão: entrada padrão)")
+    p.add_argument("-v", "--velocidade", type=float, default=1.0)
+    modo = p.add_mutually_exclusive_group()
+    modo.add_argument("-q", "--quadros", action="store_true")
+    modo.add_argument("-e", "--estatisticas", action="store_true")
+    args = p.parse_args()
+
+    entrada = open(args.arquivo, errors="replace") if args.arquivo else sys.stdin
+    largura, altura, pixels, mapa, dados = ler_despejo(entrada)
+    frames = decodificar(pixels, dados)
+
+    if args.quadros:
+        for instante, tecla, palavras in frames:
+            print("%d %s %s" % (instante, tecla, " ".join("%08x" % w for w in palavras)))
+        return 0
+    if not args.estatisticas:
+        reproduzir(frames, largura, altura, mapa, args.velocidade)
+    estatisticas(frames, dados)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,67 @@
+// Roda as animações no host, tecla por tecla, e imprime cada frame emitido:
+//   <instante em us> <tecla> <25 palavras GRB em hexadecimal>
+// Uso: simular [-g] <teclas>   (ex.: simular 1234569 0ABCD#)
+// Com -g, em vez dos frames imprime no fim o despejo do gravador (ver gravador.h),
+// que host/reproduzir.py decodifica.
+
+#include <stdio.h>
+#include <string.h>
+#include "hal_host.h"
+#include "animacoes.h"
+#include "teclado.h"
+#include "suave.h"
+#include "gravador.h"
+
+static char tecla_atual = 0;
+
+static void imprimir_frame(hal_tempo_t inicio, const uint32_t *palavras, uint n) {
+    printf("%llu %c", (unsigned long long)inicio, tecla_atual);
+    for (uint i = 0; i < n; i++) {
+        printf(" %08x", palavras[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    bool gravar = argc > 1 && !strcmp(argv[1], "-g");
+    hal_host_definir_saida(gravar ? NULL : imprimir_frame);
+
+    animacao_t animacao;
+    animacao_parar(&animacao);
+
+    for (int arg = gravar ? 2 : 1; arg < argc; arg++) {
+        for (const char *t = argv[arg]; *t; t++) {
+            // Pressiona e solta a tecla pelo mesmo caminho do teclado.pio
+            hal_host_teclado_empurrar(hal_host_retrato(*t));
+            hal_host_teclado_empurrar(hal_host_retrato(0));
+
+            teclado_evento_t evento;
+            while (teclado_evento(&evento)) {
+                animacao_passo_t comando = evento.pressionada ? comando_da_tecla(evento.tecla) : NULL;
+                if (comando) {
+                    tecla_atual = evento.tecla;
+                    gravador_tecla(evento.tecla);
+                    animacao_iniciar(&animacao, comando, hal_agora());
+                }
+            }
+
+            // Avança o relógio virtual de prazo em prazo até a animação (e a
+            // transição do modo suave) acabar, como no laço do núcleo 1
+            while (true) {
+                hal_tempo_t prazo = animacao_executar(&animacao, hal_agora());
+                hal_tempo_t renovacao = suave_renovar(hal_agora());
+                if (renovacao < prazo) {
+                    prazo = renovacao;
+                }
+                if (prazo == HAL_TEMPO_INFINITO) {
+                    break;
+                }
+                hal_host_avancar_ate(prazo);
+            }
+        }
+    }
+    if (gravar) {
+        gravador_despejar();
+    }
+    return 0;
+}
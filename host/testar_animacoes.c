@@ -0,0 +1,234 @@
+// Teste de regressão das animações sobre o PIO simulado e o relógio virtual.
+//
+// Cada caso é uma sequência de teclas; cada tecla roda até a animação (e a
+// transição do modo suave) acabar, como no simular. Dois conjuntos de
+// valores são conferidos:
+//  - esperados[]: escritos à mão a partir da definição de cada animação
+//    (animacoes/*.anim, animacoes.c): frames que saíram no fio, instante do
+//    último frame e o primeiro e o último frame, com as palavras GRB literais;
+//  - retratos[]: um retrato do código atual, sem significado por si só:
+//    passos desenhados (retornos diferentes de ANIMACAO_FIM), instante do
+//    último passo e um hash (FNV-1a) das palavras de cada frame com o instante
+//    de envio e outro dos instantes em que cada passo rodou. Pegam qualquer
+//    mudança na saída, inclusive as que os esperados não cobrem.
+// Só para a tela padrão (um painel 5x5).
+//
+// Uso: testar_animacoes [-g]
+//   -g imprime a tabela retratos[] com os valores atuais, para colar aqui
+//      depois de uma mudança intencional; esperados[] nunca é gerada
+// Sai com código 1 se algum caso não bater.
+
+#include <stdio.h>
+#include <string.h>
+#include "hal_host.h"
+#include "animacoes.h"
+#include "framebuffer.h"
+#include "suave.h"
+
+// Frame na tela, de cima para baixo, com as linhas separadas por espaço:
+// '#' = pixel com a palavra GRB 'cor', '.' = apagado
+typedef struct {
+    const char *desenho;
+    uint32_t cor;
+} frame_esperado_t;
+
+#define APAGADO {"..... ..... ..... ..... .....", 0}
+
+typedef struct {
+    const char *teclas;
+    uint32_t enviados;
+    hal_tempo_t ultimo_us; // Desde o começo do caso; 0 sem frames
+    frame_esperado_t primeiro, ultimo; // Ignorados sem frames
+} esperado_t;
+
+typedef struct {
+    const char *teclas;
+    uint32_t passos;
+    hal_tempo_t fim_us;
+    uint32_t hash_palavras;
+    uint32_t hash_prazos;
+} retrato_t;
+
+// Rodados em ordem, no mesmo processo: o estado (modo suave, último frame
+// enviado) passa de um caso para o seguinte. Um frame que começa logo depois
+// do último do caso anterior espera o latch dele: 25 * 30 + 280 = 1030 us.
+static const esperado_t esperados[] = {
+    // 0.anim: 7 frames de 500, 500, 200, 500, 200, 200 e 1100 ms e o apagado
+    // no fim; azul 128 passa pela gama para 0x38
+    {"0", 8, 3200000, {".#.#. ..... ..... .###. .....", 0x00003800}, APAGADO},
+    // Barra de baixo para cima, 5 passos de 100 ms, de vermelho até 80% do
+    // caminho para o verde: RGB(51, 204, 0), GRB 0x9a07 depois da gama
+    {"1", 5, 400000, {"..... ..... ..... ..... #####", 0x00ff0000}, {"##### ##### ##### ##### #####", 0x9a070000}},
+    // 2.anim: 5 frames de 100 ms; o último em RGB(51, 203, 0)
+    {"2", 5, 400000, {"#...# .#.#. ..#.. .#.#. #...#", 0x00ff0000}, {"..... ..#.. .#.#. ..... .....", 0x9a070000}},
+    // Cobra de 3 pixels pelo zigue-zague (17 pontos) a partir do canto
+    // inferior direito: 17 + 3 passos de 200 ms, o último já sem a cobra
+    {"3", 20, 3800000, {"..... ..... ..... ..... ....#", 0xff000000}, APAGADO},
+    // Dígitos de 1 a 9 centralizados, um por segundo
+    {"4", 9, 8000000, {"..#.. .##.. ..#.. ..#.. .###.", 0x00ff0000}, {".###. .#.#. .###. ...#. .###.", 0x00ff0000}},
+    // e.anim: 13 frames de 200 ms, 4 de 500 ms piscando e a letra de volta;
+    // os 3 frames repetidos no fim não são reenviados
+    {"5", 18, 4600000, {"..... ..... ..... ..... ....#", 0x0000ff00}, {"..##. .#..# ##### .#... ..###", 0x0000ff00}},
+    // Anéis de espessura 2: raio máximo 3 mais 2 passos de 500 ms e o
+    // apagado; o primeiro é só o centro, em azul 42 (0x05)
+    {"6", 6, 2500000, {"..... ..... ..#.. ..... .....", 0x00000500}, APAGADO},
+    // 7 voltas de 16 pontos pela borda, 50 ms cada, e o apagado; cobra de 4
+    // e centro em vermelho 51 (0x07)
+    {"9", 113, 5600000, {"..... ..... ..#.. ..... .####", 0x00070000}, APAGADO},
+    // A tela já está apagada: nada sai
+    {"A", 0, 0, APAGADO, APAGADO},
+    {"B", 1, 1030, {"##### ##### ##### ##### #####", 0x0000ff00}, {"##### ##### ##### ##### #####", 0x0000ff00}},
+    // Vermelho 80%: Q8(0.8) = 204, 0x9a depois da gama
+    {"C", 1, 1030, {"##### ##### ##### ##### #####", 0x009a0000}, {"##### ##### ##### ##### #####", 0x009a0000}},
+    // Verde 50%: 128, 0x38 depois da gama
+    {"D", 1, 1030, {"##### ##### ##### ##### #####", 0x38000000}, {"##### ##### ##### ##### #####", 0x38000000}},
+    // Branco 20%: 51, 0x07 depois da gama
+    {"#", 1, 1030, {"##### ##### ##### ##### #####", 0x07070700}, {"##### ##### ##### ##### #####", 0x07070700}},
+    {"*", 1, 1030, APAGADO, APAGADO},
+    // Modo suave: cada '2' são 201 renovações (500 ms a 400 Hz, com as duas
+    // pontas), mais o 'B'; não saem as 3 iguais à tela (o preto do começo do
+    // primeiro '2', o azul do começo do segundo e um frame do pontilhamento aos
+    // 200 ms). O segundo '2' parte do azul que o 'B' deixou na tela, e cada
+    // transição termina no frame-chave exato do '2'.
+    {"82B28", 400, 1001030, {"#...# .#.#. ..#.. .#.#. #...#", 0x00060000}, {"..... ..#.. .#.#. ..... .....", 0x9a070000}},
+};
+
+static const retrato_t retratos[] = {
+    {"0", 7, 3200000, 0x9143bc3c, 0x79ee77d4},
+    {"1", 5, 500000, 0x237a2273, 0x19b7dc6b},
+    {"2", 5, 500000, 0x731c7a20, 0x19b7dc6b},
+    {"3", 20, 4000000, 0x5e5a72ec, 0x153dc437},
+    {"4", 9, 9000000, 0xa5fdb511, 0xa1b93370},
+    {"5", 21, 6000000, 0x14ab53d6, 0x4071f120},
+    {"6", 5, 2500000, 0x8e40bb99, 0xc87cf5e0},
+    {"9", 112, 5600000, 0xb0c8e88a, 0xd2fcf5b0},
+    {"A", 0, 0, 0x811c9dc5, 0x9be17165},
+    {"B", 0, 0, 0x41d01c96, 0x9be17165},
+    {"C", 0, 0, 0x2ad24bd5, 0x9be17165},
+    {"D", 0, 0, 0xee25a3d7, 0x9be17165},
+    {"#", 0, 0, 0xa5be00e4, 0x9be17165},
+    {"*", 0, 0, 0x1a18aeef, 0x9be17165},
+    {"82B28", 10, 1001030, 0x717c1314, 0x71498b7e},
+};
+
+_Static_assert(count_of(esperados) == count_of(retratos), "esperados[] e retratos[] com casos diferentes");
+
+static uint32_t passos, enviados;
+static hal_tempo_t fim_us, ultimo_us;
+static uint32_t hash_palavras, hash_prazos;
+static uint32_t primeiro[NUM_PIXELS], ultimo[NUM_PIXELS];
+static hal_tempo_t inicio; // Instantes contam a partir do começo do caso
+
+static uint32_t fnv(uint32_t hash, uint64_t valor) {
+    for (uint i = 0; i < 8; i++) {
+        hash = (hash ^ (uint8_t)(valor >> (8 * i))) * 16777619u;
+    }
+    return hash;
+}
+
+static void saida(hal_tempo_t agora, const uint32_t *palavras, uint n) {
+    if (!enviados) {
+        memcpy(primeiro, palavras, n * sizeof(uint32_t));
+    }
+    memcpy(ultimo, palavras, n * sizeof(uint32_t));
+    ultimo_us = agora - inicio;
+    enviados++;
+    hash_palavras = fnv(hash_palavras, agora - inicio);
+    for (uint i = 0; i < n; i++) {
+        hash_palavras = fnv(hash_palavras, palavras[i]);
+    }
+}
+
+// Passo da animação da tecla atual, contado e com o instante registrado
+static animacao_passo_t alvo;
+
+static uint32_t contar(uint32_t passo) {
+    fim_us = hal_agora() - inicio;
+    hash_prazos = fnv(hash_prazos, fim_us);
+    uint32_t ms = alvo(passo);
+    if (ms != ANIMACAO_FIM) {
+        passos++;
+    }
+    return ms;
+}
+
+static void rodar(const char *teclas) {
+    passos = enviados = 0;
+    hash_palavras = hash_prazos = 2166136261u;
+    fim_us = ultimo_us = 0;
+    inicio = hal_agora();
+    animacao_t animacao;
+    animacao_parar(&animacao);
+    for (const char *t = teclas; *t; t++) {
+        alvo = comando_da_tecla(*t);
+        if (!alvo) {
+            continue;
+        }
+        animacao_iniciar(&animacao, contar, hal_agora());
+        while (true) {
+            hal_tempo_t prazo = animacao_executar(&animacao, hal_agora());
+            hal_tempo_t renovacao = suave_renovar(hal_agora());
+            if (renovacao < prazo) {
+                prazo = renovacao;
+            }
+            if (prazo == HAL_TEMPO_INFINITO) {
+                break;
+            }
+            hal_host_avancar_ate(prazo);
+        }
+    }
+}
+
+// Confere as palavras de um frame contra o desenho; imprime o primeiro pixel errado
+static bool frame_confere(const char *nome, const uint32_t *palavras, const frame_esperado_t *f) {
+    const char *p = f->desenho;
+    for (uint y = 0; y < TELA_ALTURA; y++, p++) {
+        for (uint x = 0; x < TELA_LARGURA; x++, p++) {
+            uint32_t esperada = *p == '#' ? f->cor : 0;
+            uint i = tela_indice(&tela, x, y);
+            if (palavras[i] != esperada) {
+                printf("       %s frame: pixel (%u, %u) %08x, esperado %08x\n", nome, x, y, palavras[i], esperada);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool gerar = argc > 1 && !strcmp(argv[1], "-g");
+    hal_host_definir_saida(saida);
+
+    uint erros = 0;
+    for (uint i = 0; i < count_of(retratos); i++) {
+        const esperado_t *e = &esperados[i];
+        const retrato_t *r = &retratos[i];
+        if (strcmp(e->teclas, r->teclas)) {
+            printf("caso %u: \"%s\" em esperados[], \"%s\" em retratos[]\n", i, e->teclas, r->teclas);
+            return 1;
+        }
+        rodar(r->teclas);
+        if (gerar) {
+            printf("    {\"%s\", %u, %llu, 0x%08x, 0x%08x},\n", r->teclas, passos, (unsigned long long)fim_us,
+                   hash_palavras, hash_prazos);
+            continue;
+        }
+
+        bool certo = enviados == e->enviados && ultimo_us == e->ultimo_us;
+        printf("%-6s enviados %u/%u, ultimo frame %llu/%llu us\n", e->teclas, enviados, e->enviados,
+               (unsigned long long)ultimo_us, (unsigned long long)e->ultimo_us);
+        if (enviados && e->enviados) {
+            certo &= frame_confere("primeiro", primeiro, &e->primeiro);
+            certo &= frame_confere("ultimo", ultimo, &e->ultimo);
+        }
+        bool retrato = passos == r->passos && fim_us == r->fim_us && hash_palavras == r->hash_palavras &&
+                       hash_prazos == r->hash_prazos;
+        printf("       retrato: passos %u/%u, fim %llu/%llu us, palavras %08x/%08x, prazos %08x/%08x\n", passos,
+               r->passos, (unsigned long long)fim_us, (unsigned long long)r->fim_us, hash_palavras,
+               r->hash_palavras, hash_prazos, r->hash_prazos);
+        certo &= retrato;
+        printf("       %s\n", certo ? "OK" : "ERRO");
+        erros += !certo;
+    }
+    return erros ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include "latencia.h"
+#include "teclado.h"
+#include "hardware/sync.h"
+
+#if LATENCIA
+
+#define TECLAS (TECLADO_LINHAS * TECLADO_COLUNAS)
+
+// Núcleo 0: borda pendente (escrita na IRQ do GPIO) e se a próxima borda conta
+static volatile hal_tempo_t borda = 0;
+static volatile bool armado = true;
+
+// Protege o que os dois núcleos (e a IRQ do DMA) compartilham
+static spin_lock_t *trava;
+
+// Tecla enviada pelo núcleo 0 e ainda não retirada pelo núcleo 1
+static char enviada_tecla = 0;
+static hal_tempo_t enviada_borda;
+
+// Núcleo 1: medição em andamento e se o frame que a termina já está no DMA
+static char ativa_tecla = 0;
+static hal_tempo_t ativa_borda;
+static bool em_voo = false;
+static uint32_t substituidas = 0; // Teclas cujo comando foi trocado por outro antes de um frame
+
+static uint32_t amostras[TECLAS][LATENCIA_AMOSTRAS];
+static uint32_t medidas[TECLAS];
+
+void latencia_init(void) {
+    trava = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+void latencia_borda(hal_tempo_t agora) {
+    if (armado) {
+        borda = agora;
+        armado = false;
+    }
+}
+
+void latencia_tecla(char tecla) {
+    uint32_t estado = save_and_disable_interrupts();
+    hal_tempo_t inicio = borda;
+    borda = 0;
+    restore_interrupts(estado);
+
+    if (!tecla || !inicio) {
+        return;
+    }
+    estado = spin_lock_blocking(trava);
+    enviada_tecla = tecla;
+    enviada_borda = inicio;
+    spin_unlock(trava, estado);
+}
+
+void latencia_armar(hal_tempo_t agora) {
+    uint32_t estado = save_and_disable_interrupts();
+    // A borda de uma tecla nova chega antes do evento, que passa pelo debounce
+    if (borda && agora - borda > LATENCIA_DESCARTE_US) {
+        borda = 0;
+    }
+    if (!borda) {
+        armado = true;
+    }
+    restore_interrupts(estado);
+}
+
+void latencia_comando(void) {
+    uint32_t estado = spin_lock_blocking(trava);
+    if (enviada_tecla) {
+        if (ativa_tecla) {
+            substituidas++;
+        }
+        ativa_tecla = enviada_tecla;
+        ativa_borda = enviada_borda;
+        em_voo = false;
+        enviada_tecla = 0;
+    }
+    spin_unlock(trava, estado);
+}
+
+// Chamada com a trava obtida
+static void registrar(hal_tempo_t fim) {
+    for (uint k = 0; k < TECLAS; k++) {
+        if (teclado[k / TECLADO_COLUNAS][k % TECLADO_COLUNAS] == ativa_tecla) {
+            uint64_t us = fim - ativa_borda;
+            amostras[k][medidas[k] % LATENCIA_AMOSTRAS] = us > UINT32_MAX ? UINT32_MAX : us;
+            medidas[k]++;
+            break;
+        }
+    }
+    ativa_tecla = 0;
+}
+
+void latencia_frame(bool enviado, hal_tempo_t agora) {
+    uint32_t estado = spin_lock_blocking(trava);
+    if (ativa_tecla && !em_voo) {
+        if (enviado) {
+            em_voo = true;
+        } else {
+            registrar(agora);
+        }
+    }
+    spin_unlock(trava, estado);
+}
+
+void latencia_travado(hal_tempo_t fim_latch) {
+    uint32_t estado = spin_lock_blocking(trava);
+    if (ativa_tecla && em_voo) {
+        registrar(fim_latch);
+    }
+    spin_unlock(trava, estado);
+}
+
+// Valor na posição do percentil p (1 a 100) de n amostras ordenadas, pelo posto mais próximo
+static uint32_t percentil(const uint32_t *ordenadas, uint n, uint p) {
+    return ordenadas[(p * n + 99) / 100 - 1];
+}
+
+void latencia_relatar(void) {
+    static uint32_t copia[LATENCIA_AMOSTRAS];
+
+    for (uint k = 0; k < TECLAS; k++) {
+        uint32_t estado = spin_lock_blocking(trava);
+        uint32_t total = medidas[k];
+        uint n = total < LATENCIA_AMOSTRAS ? total : LATENCIA_AMOSTRAS;
+        for (uint i = 0; i < n; i++) {
+            copia[i] = amostras[k][i];
+        }
+        spin_unlock(trava, estado);
+        if (!n) {
+            continue;
+        }
+
+        // Inserção: poucas amostras, e fora do caminho das teclas
+        for (uint i = 1; i < n; i++) {
+            uint32_t v = copia[i];
+            uint j = i;
+            for (; j > 0 && copia[j - 1] > v; j--) {
+                copia[j] = copia[j - 1];
+            }
+            copia[j] = v;
+        }
+        printf("Latencia tecla %c: %lu medidas, min %lu us, mediana %lu us, p99 %lu us, max %lu us\n",
+               teclado[k / TECLADO_COLUNAS][k % TECLADO_COLUNAS], (unsigned long)total, (unsigned long)copia[0],
+               (unsigned long)percentil(copia, n, 50), (unsigned long)percentil(copia, n, 99),
+               (unsigned long)copia[n - 1]);
+    }
+    if (substituidas) {
+        printf("Latencia: %lu teclas substituidas antes do primeiro frame\n", (unsigned long)substituidas);
+    }
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef LATENCIA_H
+#define LATENCIA_H
+
+#include "hal.h"
+
+// Medição da latência de cada tecla, da borda de descida na coluna até o
+// primeiro frame do novo modo travado nos LEDs. Só no build com -DLATENCIA=ON
+// (que também liga o stdio pela USB); sem ela as chamadas abaixo são vazias.
+#ifndef LATENCIA
+#define LATENCIA 0
+#endif
+
+// Medições guardadas por tecla; o resumo usa as mais recentes
+#define LATENCIA_AMOSTRAS 128
+
+// Medição de uma tecla pendente há mais que isso sem virar evento (ruído que o
+// debounce rejeitou) é descartada
+#define LATENCIA_DESCARTE_US 50000
+
+#if LATENCIA
+
+// Reserva o spin lock compartilhado entre os núcleos; antes de lançar o núcleo 1
+void latencia_init(void);
+
+// Núcleo 0. Borda de descida numa coluna (na IRQ do GPIO): só a primeira depois
+// de o teclado ficar livre conta, as seguintes são a varredura da tecla segurada.
+void latencia_borda(hal_tempo_t agora);
+
+// Núcleo 0. Tecla pressionada, logo antes de o comando ir para a FIFO entre
+// núcleos: a borda pendente passa a ser dessa tecla (0 descarta a borda, para
+// teclas sem comando).
+void latencia_tecla(char tecla);
+
+// Núcleo 0. Teclado livre: a próxima borda começa outra medição.
+void latencia_armar(hal_tempo_t agora);
+
+// Núcleo 1. Comando retirado da FIFO: a medição da última tecla enviada
+// termina no primeiro frame mostrado a partir daqui.
+void latencia_comando(void);
+
+// Núcleo 1, em framebuffer_mostrar. Frame enviado ao DMA (termina na IRQ) ou
+// igual ao que os LEDs já mostram (termina agora).
+void latencia_frame(bool enviado, hal_tempo_t agora);
+
+// Núcleo 1, na IRQ do DMA: instante em que o frame estará travado
+void latencia_travado(hal_tempo_t fim_latch);
+
+// Imprime mínimo, mediana, p99 e máximo das últimas medições de cada tecla
+void latencia_relatar(void);
+
+#else
+
+static inline void latencia_init(void) {}
+static inline void latencia_borda(hal_tempo_t agora) {
+    (void)agora;
+}
+static inline void latencia_tecla(char tecla) {
+    (void)tecla;
+}
+static inline void latencia_armar(hal_tempo_t agora) {
+    (void)agora;
+}
+static inline void latencia_comando(void) {}
+static inline void latencia_frame(bool enviado, hal_tempo_t agora) {
+    (void)enviado;
+    (void)agora;
+}
+static inline void latencia_travado(hal_tempo_t fim_latch) {
+    (void)fim_latch;
+}
+static inline void latencia_relatar(void) {}
+
+#endif
+
+#endif
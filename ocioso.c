@@ -0,0 +1,56 @@
+#include "ocioso.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "pio_matrix.pio.h"
+#include "teclado.h"
+#include "framebuffer.h"
+
+// Escritos no IRQ do DMA, no núcleo 1
+static volatile uint32_t despertar_us = 0;
+static volatile uint32_t despertar_max_us = 0;
+static hal_tempo_t acordou_em;
+
+// Fim do primeiro frame depois de acordar: inclui o debounce da tecla, o
+// comando pela FIFO e o envio até o latch
+static void primeiro_frame_travado(hal_tempo_t fim_latch) {
+    framebuffer_set_callback(NULL);
+    uint32_t us = (uint32_t)(fim_latch - acordou_em);
+    despertar_us = us;
+    if (us > despertar_max_us) {
+        despertar_max_us = us;
+    }
+}
+
+bool ocioso_dormir(PIO pio_saida, uint sm_saida) {
+    if (!teclado_suspender()) {
+        return false;
+    }
+
+    uint32_t khz_ativo = clock_get_hz(clk_sys) / 1000;
+    if (OCIOSO_CLOCK_KHZ) {
+        set_sys_clock_khz(OCIOSO_CLOCK_KHZ, false);
+    }
+
+    // Outras interrupções (alarmes, USB) também acordam o WFI; só a coluna encerra o modo ocioso
+    while (!teclado_acordou()) {
+        __wfi();
+    }
+    acordou_em = time_us_64();
+
+    if (OCIOSO_CLOCK_KHZ) {
+        set_sys_clock_khz(khz_ativo, true);
+        pio_matrix_program_set_clkdiv(pio_saida, sm_saida);
+    }
+    // Antes de o teclado voltar: nenhum frame sai antes do comando da tecla
+    framebuffer_set_callback(primeiro_frame_travado);
+    teclado_retomar();
+    return true;
+}
+
+uint32_t ocioso_despertar_us(void) {
+    return despertar_us;
+}
+
+uint32_t ocioso_despertar_max_us(void) {
+    return despertar_max_us;
+}
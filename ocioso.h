@@ -0,0 +1,23 @@
+#ifndef OCIOSO_H
+#define OCIOSO_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// clk_sys enquanto ocioso (0 mantém o clock atual). O divisor do pio_matrix e do
+// teclado é recalculado na volta, mantendo o WS2812 em 800 kHz.
+#ifndef OCIOSO_CLOCK_KHZ
+#define OCIOSO_CLOCK_KHZ 18000
+#endif
+
+// Suspende a varredura do teclado e dorme em WFI até uma tecla ser pressionada.
+// Só deve ser chamada com o núcleo 1 parado (sem animação nem frame em envio).
+// Retorna false se uma tecla já estava pressionada e o sistema nem dormiu.
+bool ocioso_dormir(PIO pio_saida, uint sm_saida);
+
+// Tempo entre acordar e o primeiro frame travado nos LEDs no último despertar,
+// e o maior já medido. Usa o callback do framebuffer até esse frame.
+uint32_t ocioso_despertar_us(void);
+uint32_t ocioso_despertar_max_us(void);
+
+#endif
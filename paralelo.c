@@ -0,0 +1,46 @@
+#include "paralelo.h"
+
+// Inverte a ordem dos bytes: o primeiro plano precisa ficar no byte menos
+// significativo, que o PIO desloca primeiro (vira um REV no Cortex-M0+)
+static inline uint32_t inverter_bytes(uint32_t x) {
+    return __builtin_bswap32(x);
+}
+
+// Transposição 8x8 de bits (Hacker's Delight, 7-3) sobre duas palavras: linhas
+// de entrada em x (0 a 3) e y (4 a 7), do byte mais significativo ao menos.
+// Na saída, o byte j tem o bit 7-j de cada linha, com a linha i no bit 7-i.
+static inline void transpor_8x8(uint32_t *x, uint32_t *y) {
+    uint32_t t;
+    t = (*x ^ (*x >> 7)) & 0x00AA00AA;
+    *x = *x ^ t ^ (t << 7);
+    t = (*y ^ (*y >> 7)) & 0x00AA00AA;
+    *y = *y ^ t ^ (t << 7);
+    t = (*x ^ (*x >> 14)) & 0x0000CCCC;
+    *x = *x ^ t ^ (t << 14);
+    t = (*y ^ (*y >> 14)) & 0x0000CCCC;
+    *y = *y ^ t ^ (t << 14);
+    t = (*x & 0xF0F0F0F0) | ((*y >> 4) & 0x0F0F0F0F);
+    *y = ((*x << 4) & 0xF0F0F0F0) | (*y & 0x0F0F0F0F);
+    *x = t;
+}
+
+void paralelo_transpor(const uint32_t *pixels, uint faixas, uint pixels_por_faixa, uint32_t *planos) {
+    for (uint i = 0; i < pixels_por_faixa; i++) {
+        // A faixa l vai para a linha 7-l, para sair no bit l de cada plano
+        uint32_t faixa[PARALELO_MAX_FAIXAS] = {0};
+        for (uint l = 0; l < faixas; l++) {
+            faixa[l] = pixels[l * pixels_por_faixa + i];
+        }
+
+        // G, R e B, um byte (8 planos, 2 palavras) de cada vez
+        for (int desloc = 24; desloc >= 8; desloc -= 8) {
+            uint32_t x = (faixa[7] >> desloc & 0xFF) << 24 | (faixa[6] >> desloc & 0xFF) << 16 |
+                         (faixa[5] >> desloc & 0xFF) << 8 | (faixa[4] >> desloc & 0xFF);
+            uint32_t y = (faixa[3] >> desloc & 0xFF) << 24 | (faixa[2] >> desloc & 0xFF) << 16 |
+                         (faixa[1] >> desloc & 0xFF) << 8 | (faixa[0] >> desloc & 0xFF);
+            transpor_8x8(&x, &y);
+            *planos++ = inverter_bytes(x);
+            *planos++ = inverter_bytes(y);
+        }
+    }
+}
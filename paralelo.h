@@ -0,0 +1,19 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include "hal.h"
+
+// Saída em até 8 faixas (GPIOs consecutivos) pelo programa pio_matrix_paralelo.
+// Cada palavra da FIFO leva 4 planos de bits, um por byte, começando pelo byte
+// menos significativo; no plano, o bit l é o nível da faixa l. Um pixel (24 bits
+// GRB, do mais significativo ao menos) ocupa 6 palavras, seja qual for o número
+// de faixas, então a vazão total cresce com as faixas.
+#define PARALELO_MAX_FAIXAS 8
+#define PARALELO_PALAVRAS_POR_PIXEL 6
+
+// Transpõe 'faixas' buffers GRB consecutivos (a faixa l começa em
+// pixels[l * pixels_por_faixa]) para o formato de planos de bits.
+// 'planos' recebe PARALELO_PALAVRAS_POR_PIXEL * pixels_por_faixa palavras.
+void paralelo_transpor(const uint32_t *pixels, uint faixas, uint pixels_por_faixa, uint32_t *planos);
+
+#endif
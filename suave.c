@@ -0,0 +1,132 @@
+#include "suave.h"
+#include "framebuffer.h"
+#include "cor.h"
+
+// Um período nunca é menor que o tempo de um frame no fio
+#define PERIODO_US (1000000 / SUAVE_HZ > FRAMEBUFFER_US_POR_FRAME ? 1000000 / SUAVE_HZ : FRAMEBUFFER_US_POR_FRAME)
+
+// Canais já na ordem da palavra GRB
+enum { G, R, B, CANAIS };
+
+// Frames-chave em 16 bits lineares e o erro acumulado do pontilhamento
+static uint16_t de[NUM_PIXELS][CANAIS];
+static uint16_t para[NUM_PIXELS][CANAIS];
+static uint8_t erro[NUM_PIXELS][CANAIS];
+// Frame-chave novo já em GRB: o fim da transição é o mesmo frame que sairia sem ela
+static uint32_t final[NUM_PIXELS];
+
+static bool ativo = false;
+static hal_tempo_t inicio;
+static uint32_t duracao_us;
+static hal_tempo_t proxima;
+static uint32_t mistura_atual = 0; // Q16 da última renovação
+// Envios do framebuffer até a última renovação: se houve outro depois, a tela
+// já não mostra a mistura e a próxima transição parte do frame no fio
+static uint32_t enviados_renovacao = 0;
+static suave_estatisticas_t estatisticas;
+
+static inline uint16_t misturar(uint16_t a, uint16_t b, uint32_t t) {
+    return a + (((int32_t)b - a) * (int32_t)t >> 16);
+}
+
+static uint32_t enviados_framebuffer(void) {
+    framebuffer_estatisticas_t e;
+    framebuffer_estatisticas(&e);
+    return e.enviados;
+}
+
+void suave_chave(const uint32_t *rgb, uint32_t ms, hal_tempo_t agora) {
+    const uint32_t *no_fio = NULL;
+    if (enviados_framebuffer() != enviados_renovacao) {
+        no_fio = framebuffer_enviado();
+    }
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        for (int c = 0; c < CANAIS; c++) {
+            if (no_fio) {
+                // Outro envio passou por cima: parte do frame mostrado, sem o
+                // erro de um pontilhamento que não está mais na tela
+                de[i][c] = (uint16_t)((no_fio[i] >> (24 - 8 * c) & 0xFF) << 8);
+                erro[i][c] = 0;
+            } else {
+                // A nova transição parte do ponto em que a anterior estava
+                de[i][c] = misturar(de[i][c], para[i][c], mistura_atual);
+            }
+        }
+        para[i][G] = cor_linear(RGB_G(rgb[i]));
+        para[i][R] = cor_linear(RGB_R(rgb[i]));
+        para[i][B] = cor_linear(RGB_B(rgb[i]));
+        final[i] = cor_grb(rgb[i]);
+    }
+    mistura_atual = 0;
+    inicio = agora;
+    duracao_us = ms * 1000;
+    proxima = agora;
+    ativo = true;
+}
+
+bool suave_ativo(void) {
+    return ativo;
+}
+
+void suave_parar(void) {
+    ativo = false;
+}
+
+hal_tempo_t suave_renovar(hal_tempo_t agora) {
+    if (!ativo) {
+        return HAL_TEMPO_INFINITO;
+    }
+    if (agora < proxima) {
+        return proxima;
+    }
+
+    uint32_t t = 1 << 16;
+    if (agora - inicio < duracao_us) {
+        t = (uint32_t)(((agora - inicio) << 16) / duracao_us);
+    }
+    bool ultimo = t == 1 << 16;
+
+    hal_tempo_t antes = hal_agora();
+    uint32_t *pixels = framebuffer_desenho();
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (ultimo) {
+            pixels[i] = final[i];
+            continue;
+        }
+        uint32_t palavra = 0;
+        for (int c = 0; c < CANAIS; c++) {
+            // Sigma-delta: a parte abaixo de 8 bits que não coube neste frame entra no próximo
+            uint32_t v = misturar(de[i][c], para[i][c], t) + erro[i][c];
+            uint32_t saida = v >> 8;
+            erro[i][c] = v & 0xFF;
+            palavra |= (saida > 255 ? 255 : saida) << (24 - 8 * c);
+        }
+        pixels[i] = palavra;
+    }
+    uint32_t us = hal_agora() - antes;
+    framebuffer_mostrar();
+
+    enviados_renovacao = enviados_framebuffer();
+    mistura_atual = t;
+    estatisticas.renovacoes++;
+    estatisticas.us_ultimo = us;
+    if (us > estatisticas.us_maximo) {
+        estatisticas.us_maximo = us;
+    }
+
+    if (ultimo) {
+        ativo = false;
+        return HAL_TEMPO_INFINITO;
+    }
+    proxima += PERIODO_US;
+    if (proxima <= agora) {
+        // Renovação perdida: segue a partir de agora em vez de tentar recuperar
+        estatisticas.atrasadas++;
+        proxima = agora + PERIODO_US;
+    }
+    return proxima;
+}
+
+void suave_estatisticas(suave_estatisticas_t *saida) {
+    *saida = estatisticas;
+}
@@ -0,0 +1,43 @@
+#ifndef SUAVE_H
+#define SUAVE_H
+
+#include "hal.h"
+
+// Modo suave: em vez de trocar de frame de uma vez, a saída é renovada a
+// SUAVE_HZ com a mistura linear entre o frame-chave anterior e o novo. A
+// mistura é feita em 16 bits por canal, depois da gama, e reduzida a 8 bits
+// com pontilhamento temporal, então cores fracas mantêm mais que 8 bits de
+// resolução na média.
+#ifndef SUAVE_HZ
+#define SUAVE_HZ 400
+#endif
+
+// Novo frame-chave (RGB de autoria, um por pixel na ordem do fio): a saída
+// sai do que está mostrando agora e chega nele em 'ms' (0 = troca imediata).
+// Se outro frame foi enviado depois da última renovação, é dele que ela sai.
+void suave_chave(const uint32_t *rgb, uint32_t ms, hal_tempo_t agora);
+
+// Indica se ainda há uma transição em andamento
+bool suave_ativo(void);
+
+// Interrompe a transição; a saída fica como está até o próximo envio
+void suave_parar(void);
+
+// Renova a saída se já for hora e retorna o prazo da próxima renovação
+// (HAL_TEMPO_INFINITO quando a transição terminou). O último frame de cada
+// transição é o frame-chave como sairia sem o modo suave, sem pontilhamento, e
+// pode ficar parado.
+hal_tempo_t suave_renovar(hal_tempo_t agora);
+
+// Renovações feitas, renovações que perderam o prazo e o tempo de mistura e
+// codificação de cada uma (sem o envio pelo DMA)
+typedef struct {
+    uint32_t renovacoes;
+    uint32_t atrasadas;
+    uint32_t us_ultimo;
+    uint32_t us_maximo;
+} suave_estatisticas_t;
+
+void suave_estatisticas(suave_estatisticas_t *estatisticas);
+
+#endif
@@ -0,0 +1,38 @@
+#include "teclado.h"
+
+// Mapeamento das teclas do teclado
+const char teclado[TECLADO_LINHAS][TECLADO_COLUNAS] = {
+    {'1', '2', '3', 'A'},
+    {'4', '5', '6', 'B'},
+    {'7', '8', '9', 'C'},
+    {'*', '0', '#', 'D'}};
+
+// Teclas pressionadas (bit = 1) já entregues como eventos e o último retrato lido
+static uint16_t entregue = 0;
+static uint16_t atual = 0;
+
+bool teclado_evento(teclado_evento_t *evento) {
+    // Esvazia a FIFO só quando todas as mudanças do retrato anterior foram entregues
+    while (entregue == atual) {
+        uint32_t retrato;
+        if (!hal_teclado_ler(&retrato)) {
+            return false;
+        }
+        atual = ~retrato & 0xFFFF;
+    }
+
+    // Bit k: linha 3 - k / 4 (a primeira linha lida fica nos bits altos), coluna 3 - k % 4
+    uint16_t mudancas = entregue ^ atual;
+    uint k = __builtin_ctz(mudancas);
+    entregue ^= 1u << k;
+
+    evento->linha = 3 - k / 4;
+    evento->coluna = 3 - k % 4;
+    evento->tecla = teclado[evento->linha][evento->coluna];
+    evento->pressionada = (atual >> k) & 1;
+    return true;
+}
+
+bool teclado_livre(void) {
+    return entregue == 0 && entregue == atual && hal_teclado_vazio();
+}
@@ -0,0 +1,46 @@
+#ifndef TECLADO_H
+#define TECLADO_H
+
+#include "hal.h"
+
+#define TECLADO_LINHAS 4
+#define TECLADO_COLUNAS 4
+
+typedef struct {
+    uint8_t linha;
+    uint8_t coluna;
+    char tecla;
+    bool pressionada; // false = tecla solta
+} teclado_evento_t;
+
+// Mapeamento das teclas do teclado
+extern const char teclado[TECLADO_LINHAS][TECLADO_COLUNAS];
+
+// Entrega a próxima mudança de tecla (várias teclas podem estar pressionadas
+// ao mesmo tempo). Retorna false quando não há eventos pendentes.
+bool teclado_evento(teclado_evento_t *evento);
+
+// Indica se não há tecla pressionada nem evento pendente
+bool teclado_livre(void);
+
+#if !HAL_HOST
+#include "hardware/pio.h"
+
+// Carrega o programa de varredura e inicia a máquina de estados. O teclado
+// passa a ser lido e filtrado inteiramente pelo PIO, sem custo de CPU.
+void teclado_init(PIO pio);
+
+// Modo ocioso: para a varredura, coloca todas as linhas em nível baixo e arma
+// interrupções de borda de descida nas colunas. Retorna false (sem suspender)
+// se alguma tecla já estiver pressionada.
+bool teclado_suspender(void);
+
+// Indica se uma coluna acordou o teclado suspenso
+bool teclado_acordou(void);
+
+// Desarma as interrupções e volta a varrer, recalculando o divisor do PIO
+// para o clk_sys atual
+void teclado_retomar(void);
+#endif
+
+#endif
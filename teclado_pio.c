@@ -0,0 +1,97 @@
+#include "teclado.h"
+#include "hardware/clocks.h"
+#include "teclado.pio.h"
+#include "latencia.h"
+
+// Mapa de GPIOs das linhas (fixado pelo programa teclado.pio); as colunas 0 a 3 ficam nos GPIOs 4 a 1
+static const uint gpioLinha[TECLADO_LINHAS] = {10, 9, 8, 5};
+
+#define PINO_SET 6 // Linhas 0 a 2 nos bits 4 a 2 do SET
+#define PINO_LATERAL 5 // Linha 3
+#define PINO_COLUNAS 1 // Coluna 3 no bit 0 de cada grupo de 4
+
+static PIO pio_teclado;
+static uint sm_teclado;
+static uint offset_teclado;
+static uint32_t mascara_linhas;
+
+static volatile bool acordou = false;
+
+// Qualquer coluna em nível baixo com as linhas todas em zero (suspenso) ou com a
+// linha da tecla sendo varrida (no build de latência, que deixa a IRQ sempre armada)
+static void teclado_coluna_irq(uint gpio, uint32_t eventos) {
+    (void)gpio;
+    (void)eventos;
+    acordou = true;
+    latencia_borda(time_us_64());
+}
+
+static void teclado_armar_colunas(bool armar) {
+    gpio_set_irq_enabled_with_callback(PINO_COLUNAS, GPIO_IRQ_EDGE_FALL, armar, teclado_coluna_irq);
+    for (uint i = 1; i < TECLADO_COLUNAS; i++) {
+        gpio_set_irq_enabled(PINO_COLUNAS + i, GPIO_IRQ_EDGE_FALL, armar);
+    }
+}
+
+void teclado_init(PIO pio) {
+    mascara_linhas = 0;
+    for (int i = 0; i < TECLADO_LINHAS; i++) {
+        mascara_linhas |= 1u << gpioLinha[i];
+    }
+
+    pio_teclado = pio;
+    offset_teclado = pio_add_program(pio, &teclado_program);
+    sm_teclado = pio_claim_unused_sm(pio, true);
+    teclado_program_init(pio, sm_teclado, offset_teclado, mascara_linhas, PINO_SET, PINO_LATERAL, PINO_COLUNAS);
+    if (LATENCIA) {
+        teclado_armar_colunas(true);
+    }
+}
+
+bool hal_teclado_ler(uint32_t *retrato) {
+    if (pio_sm_is_rx_fifo_empty(pio_teclado, sm_teclado)) {
+        return false;
+    }
+    *retrato = pio_sm_get(pio_teclado, sm_teclado);
+    return true;
+}
+
+bool hal_teclado_vazio(void) {
+    return pio_sm_is_rx_fifo_empty(pio_teclado, sm_teclado);
+}
+
+static bool teclado_coluna_baixa(void) {
+    return (gpio_get_all() & (0xFu << PINO_COLUNAS)) != (0xFu << PINO_COLUNAS);
+}
+
+bool teclado_suspender(void) {
+    pio_sm_set_enabled(pio_teclado, sm_teclado, false);
+    // Todas as linhas viram saída em nível baixo: qualquer tecla puxa sua coluna para zero
+    pio_sm_set_pindirs_with_mask(pio_teclado, sm_teclado, mascara_linhas, mascara_linhas);
+
+    acordou = false;
+    teclado_armar_colunas(true);
+
+    // Tecla pressionada entre a última varredura e o armar das interrupções
+    if (teclado_coluna_baixa()) {
+        teclado_retomar();
+        return false;
+    }
+    return true;
+}
+
+bool teclado_acordou(void) {
+    return acordou;
+}
+
+void teclado_retomar(void) {
+    teclado_armar_colunas(LATENCIA);
+    pio_sm_set_pindirs_with_mask(pio_teclado, sm_teclado, 0, mascara_linhas);
+
+    // Recomeça o programa do início, que zera o último retrato enviado; a tecla
+    // que acordou o sistema sai como evento depois do debounce
+    teclado_program_set_clkdiv(pio_teclado, sm_teclado);
+    pio_sm_restart(pio_teclado, sm_teclado);
+    pio_sm_exec(pio_teclado, sm_teclado, pio_encode_jmp(offset_teclado));
+    pio_sm_set_enabled(pio_teclado, sm_teclado, true);
+}
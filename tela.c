@@ -0,0 +1,79 @@
+#include "tela.h"
+
+// Percurso dos frames 5x5 (frame_t): o mesmo do painel da placa, que começa no
+// canto inferior direito e alterna o sentido a cada linha
+#define FRAME_PERCURSO {.inicio_embaixo = true, .inicio_direita = true, .serpentina = true}
+
+const tela_t tela = {
+    .painel_largura = TELA_PAINEL_LARGURA,
+    .painel_altura = TELA_PAINEL_ALTURA,
+    .paineis_x = TELA_PAINEIS_X,
+    .paineis_y = TELA_PAINEIS_Y,
+    .painel = FRAME_PERCURSO,
+    // Painéis em fileiras a partir do canto superior esquerdo, em zigue-zague
+    // para o cabo de um painel alcançar o próximo
+    .cadeia = {.inicio_embaixo = false, .inicio_direita = false, .serpentina = true},
+    .pino = TELA_PINO,
+    .faixas = TELA_FAIXAS,
+};
+
+static uint percorrer(const tela_percurso_t *p, uint largura, uint altura, uint x, uint y) {
+    uint linha = p->inicio_embaixo ? altura - 1 - y : y;
+    bool direita = p->inicio_direita ^ (p->serpentina && (linha & 1));
+    uint coluna = direita ? largura - 1 - x : x;
+    return linha * largura + coluna;
+}
+
+uint tela_indice(const tela_t *t, uint x, uint y) {
+    uint px = x / t->painel_largura;
+    uint py = y / t->painel_altura;
+    uint painel = percorrer(&t->cadeia, t->paineis_x, t->paineis_y, px, py);
+    return painel * t->painel_largura * t->painel_altura +
+           percorrer(&t->painel, t->painel_largura, t->painel_altura, x - px * t->painel_largura, y - py * t->painel_altura);
+}
+
+uint tela_trecho(const tela_t *t, uint x, uint y, int *passo) {
+    uint inicio = tela_indice(t, x, y);
+    if (t->painel_largura == 1) {
+        *passo = 1;
+    } else if ((x + 1) % t->painel_largura) {
+        *passo = (int)tela_indice(t, x + 1, y) - (int)inicio;
+    } else {
+        *passo = inicio - tela_indice(t, x - 1, y); // Último pixel da linha do painel
+    }
+    return inicio;
+}
+
+void tela_desenhar_frame(const tela_t *t, uint32_t *pixels, int x, int y, frame_t frame, uint32_t cor) {
+    static const tela_percurso_t percurso_frame = FRAME_PERCURSO;
+    int largura = t->painel_largura * t->paineis_x;
+    int altura = t->painel_altura * t->paineis_y;
+
+    // Frame alinhado a um painel 5x5 com a mesma fiação: os 25 pixels são
+    // contíguos no fio e já estão na ordem do frame_t
+    if (t->painel_largura == FRAME_LADO && t->painel_altura == FRAME_LADO &&
+        t->painel.inicio_embaixo == percurso_frame.inicio_embaixo &&
+        t->painel.inicio_direita == percurso_frame.inicio_direita &&
+        t->painel.serpentina == percurso_frame.serpentina &&
+        x >= 0 && y >= 0 && x < largura && y < altura && x % FRAME_LADO == 0 && y % FRAME_LADO == 0) {
+        frame_renderizar(&pixels[tela_indice(t, x, y) / FRAME_PIXELS * FRAME_PIXELS], frame, cor);
+        return;
+    }
+
+    // Caso geral: pixel a pixel, do bit 0 do frame_t em diante
+    for (int r = 0; r < FRAME_LADO; r++) {
+        int fy = y + FRAME_LADO - 1 - r;
+        for (int c = 0; c < FRAME_LADO; c++) {
+            int fx = x + ((r & 1) ? c : FRAME_LADO - 1 - c);
+            if (fx >= 0 && fy >= 0 && fx < largura && fy < altura) {
+                pixels[tela_indice(t, fx, fy)] = cor & -(frame & 1);
+            }
+            frame >>= 1;
+        }
+    }
+}
+
+void tela_origem_painel(const tela_t *t, uint painel_x, uint painel_y, int *x, int *y) {
+    *x = painel_x * t->painel_largura + (t->painel_largura - FRAME_LADO) / 2;
+    *y = painel_y * t->painel_altura + (t->painel_altura - FRAME_LADO) / 2;
+}
@@ -0,0 +1,78 @@
+#ifndef TELA_H
+#define TELA_H
+
+#include "hal.h"
+#include "frames.h"
+
+// Geometria da tela, fixada no build (os buffers do framebuffer são estáticos).
+// Uma tela é uma grade de painéis iguais ligados em sequência numa única linha
+// de dados. O padrão é o painel 5x5 da placa, sozinho.
+#ifndef TELA_PAINEL_LARGURA
+#define TELA_PAINEL_LARGURA 5
+#endif
+#ifndef TELA_PAINEL_ALTURA
+#define TELA_PAINEL_ALTURA 5
+#endif
+#ifndef TELA_PAINEIS_X
+#define TELA_PAINEIS_X 1
+#endif
+#ifndef TELA_PAINEIS_Y
+#define TELA_PAINEIS_Y 1
+#endif
+#ifndef TELA_PINO
+#define TELA_PINO 7
+#endif
+// Faixas de saída em paralelo, a partir de TELA_PINO (ver paralelo.h). A
+// corrente é dividida em partes iguais e consecutivas, uma por faixa.
+#ifndef TELA_FAIXAS
+#define TELA_FAIXAS 1
+#endif
+
+#define TELA_LARGURA (TELA_PAINEL_LARGURA * TELA_PAINEIS_X)
+#define TELA_ALTURA (TELA_PAINEL_ALTURA * TELA_PAINEIS_Y)
+#define TELA_PIXELS (TELA_LARGURA * TELA_ALTURA)
+#define TELA_PIXELS_POR_FAIXA (TELA_PIXELS / TELA_FAIXAS)
+
+#if TELA_FAIXAS < 1 || TELA_FAIXAS > 8 || TELA_PIXELS % TELA_FAIXAS
+#error "TELA_FAIXAS precisa estar entre 1 e 8 e dividir a corrente em partes iguais"
+#endif
+
+// Ordem em que uma grade é percorrida no fio: canto do primeiro elemento e se
+// as linhas alternam de sentido (zigue-zague)
+typedef struct {
+    bool inicio_embaixo;
+    bool inicio_direita;
+    bool serpentina;
+} tela_percurso_t;
+
+// Descritor da tela. Coordenadas (x, y) são como a tela é vista: (0, 0) no
+// canto superior esquerdo.
+typedef struct {
+    uint8_t painel_largura;
+    uint8_t painel_altura;
+    uint8_t paineis_x;
+    uint8_t paineis_y;
+    tela_percurso_t painel; // Ordem dos LEDs dentro de cada painel
+    tela_percurso_t cadeia; // Ordem dos painéis na corrente
+    uint8_t pino;           // GPIO da linha de dados (da primeira, com várias faixas)
+    uint8_t faixas;         // Linhas de dados em paralelo, em GPIOs consecutivos
+} tela_t;
+
+extern const tela_t tela;
+
+// Posição (x, y) na ordem do fio, ou seja, o índice no buffer do framebuffer
+uint tela_indice(const tela_t *t, uint x, uint y);
+
+// Pixels (x, y) a (x + n - 1, y) dentro do mesmo painel ficam em sequência no
+// fio: retorna o índice do primeiro e coloca em *passo a distância (+1 ou -1)
+// entre vizinhos. Útil para percorrer a tela linha a linha, painel a painel.
+uint tela_trecho(const tela_t *t, uint x, uint y, int *passo);
+
+// Desenha um frame 5x5 com o canto superior esquerdo em (x, y), sem tocar nos
+// outros pixels. O que sair da tela é cortado.
+void tela_desenhar_frame(const tela_t *t, uint32_t *pixels, int x, int y, frame_t frame, uint32_t cor);
+
+// Canto superior esquerdo de um frame 5x5 centralizado no painel indicado
+void tela_origem_painel(const tela_t *t, uint painel_x, uint painel_y, int *x, int *y);
+
+#endif
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <string.h>
+#include "telemetria.h"
+#include "animacoes.h"
+#include "hardware/sync.h"
+
+#if TELEMETRIA
+
+// Métricas por frame, na ordem em que aparecem no resumo
+enum { RENDER, TRANSFERENCIA, ATRASO, JITTER, METRICAS };
+static const char metrica_letra[METRICAS] = {'r', 't', 'a', 'j'};
+
+typedef struct {
+    animacao_passo_t passo;
+    uint32_t frames;
+    uint32_t perdidos;
+    uint32_t maximo[METRICAS];
+    uint16_t baldes[METRICAS][TELEMETRIA_BALDES];
+} janela_t;
+
+// Escritas no núcleo 1 (passos e IRQ do DMA, que também roda nele)
+static janela_t janelas[TELEMETRIA_ANIMACOES];
+static janela_t copia[TELEMETRIA_ANIMACOES];
+static uint32_t descartados = 0; // Passos de animações além de TELEMETRIA_ANIMACOES
+
+static volatile int janela_dma = -1; // Janela da animação que enviou o frame em transferência
+static hal_tempo_t inicio_dma;
+static animacao_passo_t ultimo_passo = NULL;
+static hal_tempo_t ultimo_inicio, ultimo_prazo;
+static hal_tempo_t inicio_janela = 0;
+static hal_tempo_t proximo_resumo = 0;
+
+static void registrar(janela_t *j, uint metrica, uint64_t us) {
+    uint32_t valor = us > UINT32_MAX ? UINT32_MAX : us;
+    uint balde = valor ? 32 - __builtin_clz(valor) : 0;
+    if (balde >= TELEMETRIA_BALDES) {
+        balde = TELEMETRIA_BALDES - 1;
+    }
+    if (j->baldes[metrica][balde] < UINT16_MAX) {
+        j->baldes[metrica][balde]++;
+    }
+    if (valor > j->maximo[metrica]) {
+        j->maximo[metrica] = valor;
+    }
+}
+
+static janela_t *janela_de(animacao_passo_t passo) {
+    for (uint i = 0; i < TELEMETRIA_ANIMACOES; i++) {
+        if (janelas[i].passo == passo) {
+            return &janelas[i];
+        }
+        if (!janelas[i].passo) {
+            janelas[i].passo = passo;
+            return &janelas[i];
+        }
+    }
+    return NULL;
+}
+
+void telemetria_passo(animacao_passo_t passo, hal_tempo_t prazo, hal_tempo_t inicio, hal_tempo_t fim) {
+    janela_t *j = janela_de(passo);
+    if (!j) {
+        descartados++;
+        return;
+    }
+    janela_dma = j - janelas;
+    j->frames++;
+    registrar(j, RENDER, fim - inicio);
+
+    uint64_t atraso = inicio > prazo ? inicio - prazo : 0;
+    registrar(j, ATRASO, atraso);
+    if (atraso >= TELEMETRIA_PERDIDO_US) {
+        j->perdidos++;
+    }
+
+    // Jitter: diferença entre o intervalo real desde o passo anterior e o agendado
+    if (passo == ultimo_passo) {
+        int64_t real = inicio - ultimo_inicio;
+        int64_t agendado = prazo - ultimo_prazo;
+        registrar(j, JITTER, real > agendado ? real - agendado : agendado - real);
+    }
+    ultimo_passo = passo;
+    ultimo_inicio = inicio;
+    ultimo_prazo = prazo;
+}
+
+void telemetria_dma_inicio(hal_tempo_t agora) {
+    inicio_dma = agora;
+}
+
+void telemetria_dma_fim(hal_tempo_t agora) {
+    if (janela_dma >= 0) {
+        registrar(&janelas[janela_dma], TRANSFERENCIA, agora - inicio_dma);
+    }
+}
+
+hal_tempo_t telemetria_relatar(hal_tempo_t agora) {
+    if (agora < proximo_resumo) {
+        return proximo_resumo;
+    }
+
+    // Copia e zera de uma vez, sem a IRQ do DMA no meio
+    uint32_t estado = save_and_disable_interrupts();
+    memcpy(copia, janelas, sizeof(janelas));
+    memset(janelas, 0, sizeof(janelas));
+    janela_dma = -1;
+    uint32_t sem_janela = descartados;
+    descartados = 0;
+    restore_interrupts(estado);
+
+    // Uma linha por animação ativa:
+    //   T <janela ms> <tecla> <frames> <perdidos> r<máx>:<baldes> t... a... j...
+    // com os baldes em log2 de us separados por vírgula, sem os zeros do fim
+    uint32_t janela_ms = (agora - inicio_janela) / 1000;
+    for (uint i = 0; i < TELEMETRIA_ANIMACOES && copia[i].passo; i++) {
+        const janela_t *j = &copia[i];
+        char tecla = tecla_do_comando(j->passo);
+        printf("T %lu %c %lu %lu", (unsigned long)janela_ms, tecla ? tecla : '?', (unsigned long)j->frames,
+               (unsigned long)j->perdidos);
+        for (uint m = 0; m < METRICAS; m++) {
+            int ultimo = TELEMETRIA_BALDES - 1;
+            while (ultimo > 0 && !j->baldes[m][ultimo]) {
+                ultimo--;
+            }
+            printf(" %c%lu:", metrica_letra[m], (unsigned long)j->maximo[m]);
+            for (int b = 0; b <= ultimo; b++) {
+                printf(b ? ",%u" : "%u", j->baldes[m][b]);
+            }
+        }
+        printf("\n");
+    }
+    if (sem_janela) {
+        printf("T %lu descartados %lu\n", (unsigned long)janela_ms, (unsigned long)sem_janela);
+    }
+
+    inicio_janela = agora;
+    proximo_resumo = agora + TELEMETRIA_PERIODO_MS * 1000;
+    return proximo_resumo;
+}
+
+#endif
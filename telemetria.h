@@ -0,0 +1,56 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include "hal.h"
+#include "animacao.h"
+
+// Telemetria de tempo dos frames, só no build com -DTELEMETRIA=ON (que também
+// liga o stdio pela USB). Sem ela as chamadas abaixo são vazias e somem.
+#ifndef TELEMETRIA
+#define TELEMETRIA 0
+#endif
+
+// Janela de cada resumo; os histogramas recomeçam a cada resumo
+#define TELEMETRIA_PERIODO_MS 1000
+// Animações distintas acompanhadas por janela
+#define TELEMETRIA_ANIMACOES 8
+// Baldes de log2 em us: 0, 1, 2-3, 4-7, ..., 16384 ou mais
+#define TELEMETRIA_BALDES 16
+// Atraso a partir do qual um passo conta como prazo perdido
+#define TELEMETRIA_PERDIDO_US 1000
+
+#if TELEMETRIA
+
+// Um passo da animação: prazo, início e fim do desenho (inclui esperar o frame
+// anterior sair e disparar o DMA)
+void telemetria_passo(animacao_passo_t passo, hal_tempo_t prazo, hal_tempo_t inicio, hal_tempo_t fim);
+
+// Início da transferência pelo DMA e fim dela (chamado na IRQ)
+void telemetria_dma_inicio(hal_tempo_t agora);
+void telemetria_dma_fim(hal_tempo_t agora);
+
+// Imprime o resumo da janela e recomeça se já for hora. Retorna o prazo do próximo.
+hal_tempo_t telemetria_relatar(hal_tempo_t agora);
+
+#else
+
+static inline void telemetria_passo(animacao_passo_t passo, hal_tempo_t prazo, hal_tempo_t inicio, hal_tempo_t fim) {
+    (void)passo;
+    (void)prazo;
+    (void)inicio;
+    (void)fim;
+}
+static inline void telemetria_dma_inicio(hal_tempo_t agora) {
+    (void)agora;
+}
+static inline void telemetria_dma_fim(hal_tempo_t agora) {
+    (void)agora;
+}
+static inline hal_tempo_t telemetria_relatar(hal_tempo_t agora) {
+    (void)agora;
+    return HAL_TEMPO_INFINITO;
+}
+
+#endif
+
+#endif
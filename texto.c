@@ -0,0 +1,152 @@
+#include <string.h>
+#include "texto.h"
+
+// Glifo escrito por linhas, de cima para baixo, com o bit mais alto de cada
+// linha na coluna da esquerda; a fonte guarda as colunas
+#define GLIFO_BIT(linha, l, w, c) ((((l) >> (((w) - 1 - (c)) & 7)) & 1) << (linha))
+#define GLIFO_COLUNA(w, c, l0, l1, l2, l3, l4) ((uint32_t)((c) < (w) ? \
+    GLIFO_BIT(0, l0, w, c) | GLIFO_BIT(1, l1, w, c) | GLIFO_BIT(2, l2, w, c) | \
+    GLIFO_BIT(3, l3, w, c) | GLIFO_BIT(4, l4, w, c) : 0) << (5 * (c)))
+#define GLIFO(w, l0, l1, l2, l3, l4) ((uint32_t)(w) << 25 | \
+    GLIFO_COLUNA(w, 0, l0, l1, l2, l3, l4) | GLIFO_COLUNA(w, 1, l0, l1, l2, l3, l4) | \
+    GLIFO_COLUNA(w, 2, l0, l1, l2, l3, l4) | GLIFO_COLUNA(w, 3, l0, l1, l2, l3, l4) | \
+    GLIFO_COLUNA(w, 4, l0, l1, l2, l3, l4))
+
+#define PRIMEIRO ' '
+#define ULTIMO 'Z'
+
+// Caracteres de ' ' a 'Z'; 0 = fora da fonte
+static const uint32_t fonte[ULTIMO - PRIMEIRO + 1] = {
+    [' ' - PRIMEIRO] = GLIFO(2, 0b00, 0b00, 0b00, 0b00, 0b00),
+    ['!' - PRIMEIRO] = GLIFO(1, 0b1, 0b1, 0b1, 0b0, 0b1),
+    ['#' - PRIMEIRO] = GLIFO(5, 0b01010, 0b11111, 0b01010, 0b11111, 0b01010),
+    ['%' - PRIMEIRO] = GLIFO(3, 0b101, 0b001, 0b010, 0b100, 0b101),
+    ['\'' - PRIMEIRO] = GLIFO(1, 0b1, 0b1, 0b0, 0b0, 0b0),
+    ['(' - PRIMEIRO] = GLIFO(2, 0b01, 0b10, 0b10, 0b10, 0b01),
+    [')' - PRIMEIRO] = GLIFO(2, 0b10, 0b01, 0b01, 0b01, 0b10),
+    ['*' - PRIMEIRO] = GLIFO(3, 0b000, 0b101, 0b010, 0b101, 0b000),
+    ['+' - PRIMEIRO] = GLIFO(3, 0b000, 0b010, 0b111, 0b010, 0b000),
+    [',' - PRIMEIRO] = GLIFO(2, 0b00, 0b00, 0b00, 0b01, 0b10),
+    ['-' - PRIMEIRO] = GLIFO(3, 0b000, 0b000, 0b111, 0b000, 0b000),
+    ['.' - PRIMEIRO] = GLIFO(1, 0b0, 0b0, 0b0, 0b0, 0b1),
+    ['/' - PRIMEIRO] = GLIFO(3, 0b001, 0b001, 0b010, 0b100, 0b100),
+    ['0' - PRIMEIRO] = GLIFO(3, 0b111, 0b101, 0b101, 0b101, 0b111),
+    ['1' - PRIMEIRO] = GLIFO(3, 0b010, 0b110, 0b010, 0b010, 0b111),
+    ['2' - PRIMEIRO] = GLIFO(3, 0b111, 0b001, 0b111, 0b100, 0b111),
+    ['3' - PRIMEIRO] = GLIFO(3, 0b111, 0b001, 0b111, 0b001, 0b111),
+    ['4' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b111, 0b001, 0b001),
+    ['5' - PRIMEIRO] = GLIFO(3, 0b111, 0b100, 0b111, 0b001, 0b111),
+    ['6' - PRIMEIRO] = GLIFO(3, 0b111, 0b100, 0b111, 0b101, 0b111),
+    ['7' - PRIMEIRO] = GLIFO(3, 0b111, 0b001, 0b001, 0b010, 0b010),
+    ['8' - PRIMEIRO] = GLIFO(3, 0b111, 0b101, 0b111, 0b101, 0b111),
+    ['9' - PRIMEIRO] = GLIFO(3, 0b111, 0b101, 0b111, 0b001, 0b111),
+    [':' - PRIMEIRO] = GLIFO(1, 0b0, 0b1, 0b0, 0b1, 0b0),
+    ['<' - PRIMEIRO] = GLIFO(3, 0b001, 0b010, 0b100, 0b010, 0b001),
+    ['=' - PRIMEIRO] = GLIFO(3, 0b000, 0b111, 0b000, 0b111, 0b000),
+    ['>' - PRIMEIRO] = GLIFO(3, 0b100, 0b010, 0b001, 0b010, 0b100),
+    ['?' - PRIMEIRO] = GLIFO(3, 0b110, 0b001, 0b010, 0b000, 0b010),
+    ['A' - PRIMEIRO] = GLIFO(3, 0b010, 0b101, 0b111, 0b101, 0b101),
+    ['B' - PRIMEIRO] = GLIFO(3, 0b110, 0b101, 0b110, 0b101, 0b110),
+    ['C' - PRIMEIRO] = GLIFO(3, 0b011, 0b100, 0b100, 0b100, 0b011),
+    ['D' - PRIMEIRO] = GLIFO(3, 0b110, 0b101, 0b101, 0b101, 0b110),
+    ['E' - PRIMEIRO] = GLIFO(3, 0b111, 0b100, 0b110, 0b100, 0b111),
+    ['F' - PRIMEIRO] = GLIFO(3, 0b111, 0b100, 0b110, 0b100, 0b100),
+    ['G' - PRIMEIRO] = GLIFO(3, 0b011, 0b100, 0b101, 0b101, 0b011),
+    ['H' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b111, 0b101, 0b101),
+    ['I' - PRIMEIRO] = GLIFO(3, 0b111, 0b010, 0b010, 0b010, 0b111),
+    ['J' - PRIMEIRO] = GLIFO(3, 0b001, 0b001, 0b001, 0b101, 0b010),
+    ['K' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b110, 0b101, 0b101),
+    ['L' - PRIMEIRO] = GLIFO(3, 0b100, 0b100, 0b100, 0b100, 0b111),
+    ['M' - PRIMEIRO] = GLIFO(5, 0b10001, 0b11011, 0b10101, 0b10001, 0b10001),
+    ['N' - PRIMEIRO] = GLIFO(4, 0b1001, 0b1101, 0b1011, 0b1001, 0b1001),
+    ['O' - PRIMEIRO] = GLIFO(3, 0b010, 0b101, 0b101, 0b101, 0b010),
+    ['P' - PRIMEIRO] = GLIFO(3, 0b110, 0b101, 0b110, 0b100, 0b100),
+    ['Q' - PRIMEIRO] = GLIFO(3, 0b010, 0b101, 0b101, 0b110, 0b011),
+    ['R' - PRIMEIRO] = GLIFO(3, 0b110, 0b101, 0b110, 0b101, 0b101),
+    ['S' - PRIMEIRO] = GLIFO(3, 0b011, 0b100, 0b010, 0b001, 0b110),
+    ['T' - PRIMEIRO] = GLIFO(3, 0b111, 0b010, 0b010, 0b010, 0b010),
+    ['U' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b101, 0b101, 0b111),
+    ['V' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b101, 0b101, 0b010),
+    ['W' - PRIMEIRO] = GLIFO(5, 0b10001, 0b10001, 0b10101, 0b11011, 0b10001),
+    ['X' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b010, 0b101, 0b101),
+    ['Y' - PRIMEIRO] = GLIFO(3, 0b101, 0b101, 0b010, 0b010, 0b010),
+    ['Z' - PRIMEIRO] = GLIFO(3, 0b111, 0b001, 0b010, 0b100, 0b111),
+};
+
+uint32_t texto_glifo(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c -= 'a' - 'A';
+    }
+    uint32_t glifo = c >= PRIMEIRO && c <= ULTIMO ? fonte[c - PRIMEIRO] : 0;
+    return glifo ? glifo : fonte['?' - PRIMEIRO];
+}
+
+uint texto_largura(const char *s) {
+    uint largura = 0;
+    for (; *s; s++) {
+        largura += texto_glifo_largura(texto_glifo(*s)) + TEXTO_ESPACO;
+    }
+    return largura ? largura - TEXTO_ESPACO : 0;
+}
+
+// Uma coluna de glifo em x, com a linha de cima em y; as linhas fora da tela são cortadas
+static void desenhar_coluna(uint32_t *pixels, uint x, int y, uint8_t bits, uint32_t cor, bool apagar) {
+    for (int linha = 0; linha < TEXTO_ALTURA; linha++) {
+        int py = y + linha;
+        if (py < 0 || py >= TELA_ALTURA) {
+            continue;
+        }
+        if (bits >> linha & 1) {
+            pixels[tela_indice(&tela, x, py)] = cor;
+        } else if (apagar) {
+            pixels[tela_indice(&tela, x, py)] = 0;
+        }
+    }
+}
+
+void texto_desenhar(uint32_t *pixels, const char *s, int x, int y, uint32_t cor) {
+    for (; *s && x < TELA_LARGURA; s++) {
+        uint32_t glifo = texto_glifo(*s);
+        uint largura = texto_glifo_largura(glifo);
+        for (uint c = 0; c < largura; c++) {
+            int px = x + (int)c;
+            if (px >= 0 && px < TELA_LARGURA) {
+                desenhar_coluna(pixels, px, y, texto_glifo_coluna(glifo, c), cor, false);
+            }
+        }
+        x += largura + TEXTO_ESPACO;
+    }
+}
+
+void texto_letreiro_iniciar(texto_letreiro_t *l, const char *s) {
+    l->proximo = s;
+    l->glifo = 0;
+    l->coluna = TEXTO_ESPACO; // Já no fim do glifo vazio: o primeiro avanço lê o texto
+    // O espaço depois do último glifo já conta como a primeira coluna vazia
+    l->restantes = TELA_LARGURA - TEXTO_ESPACO;
+    memset(l->janela, 0, sizeof(l->janela));
+}
+
+bool texto_letreiro_avancar(texto_letreiro_t *l) {
+    uint8_t nova = 0;
+    if (l->coluna >= texto_glifo_largura(l->glifo) + TEXTO_ESPACO && *l->proximo) {
+        l->glifo = texto_glifo(*l->proximo++);
+        l->coluna = 0;
+    }
+    if (l->coluna < texto_glifo_largura(l->glifo) + TEXTO_ESPACO) {
+        nova = texto_glifo_coluna(l->glifo, l->coluna++);
+    } else if (l->restantes) {
+        l->restantes--;
+    } else {
+        return false;
+    }
+    memmove(l->janela, l->janela + 1, TELA_LARGURA - 1);
+    l->janela[TELA_LARGURA - 1] = nova;
+    return true;
+}
+
+void texto_letreiro_desenhar(const texto_letreiro_t *l, uint32_t *pixels, int y, uint32_t cor) {
+    for (uint x = 0; x < TELA_LARGURA; x++) {
+        desenhar_coluna(pixels, x, y, l->janela[x], cor, true);
+    }
+}
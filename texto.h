@@ -0,0 +1,54 @@
+#ifndef TEXTO_H
+#define TEXTO_H
+
+#include "hal.h"
+#include "tela.h"
+
+// Texto em fonte bitmap de 5 linhas, guardada por colunas. Cada glifo cabe numa
+// palavra: a coluna c nos bits 5c a 5c + 4 (bit 0 = linha de cima) e a largura
+// (1 a 5 colunas) nos bits 25 a 27. Há dígitos, letras (minúsculas viram
+// maiúsculas) e alguns símbolos; o que não está na fonte vira '?'.
+#define TEXTO_ALTURA 5
+// Colunas apagadas depois de cada glifo
+#define TEXTO_ESPACO 1
+
+uint32_t texto_glifo(char c);
+
+static inline uint texto_glifo_largura(uint32_t glifo) {
+    return glifo >> 25;
+}
+
+static inline uint8_t texto_glifo_coluna(uint32_t glifo, uint c) {
+    return c < texto_glifo_largura(glifo) ? glifo >> (5 * c) & 0x1F : 0;
+}
+
+// Colunas ocupadas pelo texto, sem o espaço depois do último glifo
+uint texto_largura(const char *s);
+
+// Desenha o texto com a coluna da esquerda em x e a linha de cima em y, só nos
+// pixels acesos. O que sair da tela é cortado; os glifos depois da borda
+// direita nem são lidos.
+void texto_desenhar(uint32_t *pixels, const char *s, int x, int y, uint32_t cor);
+
+// Letreiro rolando da direita para a esquerda pela largura da tela inteira
+// (todos os painéis de uma linha). A janela guarda só as colunas visíveis:
+// cada passo desloca a janela uma coluna e lê uma coluna nova do texto, então o
+// custo não depende do tamanho do texto.
+typedef struct {
+    const char *proximo; // Próximo caractere a entrar
+    uint32_t glifo;      // Glifo entrando pela direita
+    uint8_t coluna;      // Próxima coluna dele (as depois da largura são o espaço)
+    uint16_t restantes;  // Colunas vazias que ainda entram depois do fim do texto
+    uint8_t janela[TELA_LARGURA];
+} texto_letreiro_t;
+
+// Começa com a tela vazia; o texto (que precisa continuar válido) entra pela direita
+void texto_letreiro_iniciar(texto_letreiro_t *l, const char *s);
+
+// Desloca uma coluna; false quando o texto já saiu inteiro pela esquerda
+bool texto_letreiro_avancar(texto_letreiro_t *l);
+
+// Desenha as TEXTO_ALTURA linhas a partir de y, acesas e apagadas
+void texto_letreiro_desenhar(const texto_letreiro_t *l, uint32_t *pixels, int y, uint32_t cor);
+
+#endif
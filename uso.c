@@ -0,0 +1,47 @@
+#include "uso.h"
+
+typedef struct {
+    volatile uint32_t ocupado_us; // Total acumulado (dá a volta a cada ~71 min; só as diferenças importam)
+    volatile uint32_t inicio_us;  // Início do trecho ocupado atual
+    volatile bool ocupado;
+    // Estado da última leitura, usado só por quem chama uso_percentual
+    uint32_t lido_ocupado_us;
+    uint32_t lido_em_us;
+} uso_nucleo_t;
+
+static uso_nucleo_t nucleos[NUM_CORES];
+
+void uso_ocupado(void) {
+    uso_nucleo_t *n = &nucleos[get_core_num()];
+    if (!n->ocupado) {
+        n->inicio_us = time_us_32();
+        n->ocupado = true;
+    }
+}
+
+void uso_ocioso(void) {
+    uso_nucleo_t *n = &nucleos[get_core_num()];
+    if (n->ocupado) {
+        n->ocupado_us += time_us_32() - n->inicio_us;
+        n->ocupado = false;
+    }
+}
+
+uint uso_percentual(uint nucleo) {
+    uso_nucleo_t *n = &nucleos[nucleo];
+    uint32_t agora = time_us_32();
+    uint32_t ocupado = n->ocupado_us;
+    if (n->ocupado) {
+        ocupado += agora - n->inicio_us; // Trecho ainda em andamento
+    }
+
+    uint32_t janela = agora - n->lido_em_us;
+    uint32_t delta = ocupado - n->lido_ocupado_us;
+    n->lido_em_us = agora;
+    n->lido_ocupado_us = ocupado;
+
+    if (janela == 0) {
+        return 0;
+    }
+    return (uint)((uint64_t)delta * 100 / janela);
+}
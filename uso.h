@@ -0,0 +1,15 @@
+#ifndef USO_H
+#define USO_H
+
+#include "pico/stdlib.h"
+
+// Contabiliza o tempo ocupado de cada núcleo. Cada núcleo marca quando
+// começa a trabalhar e quando volta a dormir; o acúmulo é feito por núcleo,
+// então as duas funções podem ser chamadas dos dois lados sem trava.
+void uso_ocupado(void);
+void uso_ocioso(void);
+
+// Percentual de ocupação do núcleo desde a leitura anterior deste mesmo núcleo
+uint uso_percentual(uint nucleo);
+
+#endif